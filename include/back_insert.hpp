@@ -16,11 +16,71 @@
 #ifndef STD_RANGEIO_back_insert_
 #define STD_RANGEIO_back_insert_
 
+#include <algorithm>
+#include <ios>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
 #include "input.hpp"
 
 namespace std {
+
+/** Tag type to request that space is reserved in the range for the
+ * values estimated to be left in the stream.
+ */
+struct estimate_size_t
+{
+  explicit estimate_size_t() = default;
+};
+
+constexpr estimate_size_t estimate_size{};
+
 namespace rangeio_detail {
 
+/** Reserves space for more elements in a range.
+ * 
+ * Nothing is done if the range already has room. Otherwise, the
+ * capacity is at least doubled, just as <tt>push_back()</tt> would
+ * grow it, so that reserving a little more space over and over -
+ * as reading with <tt>back_insert_n(r, 1)</tt> in a loop does -
+ * doesn't reallocate every time.
+ * 
+ * The reservation is only a hint: if it fails, nothing happens.
+ * 
+ * \param  r   The range.
+ * \param  n   The number of elements to reserve space for, in
+ *             addition to the ones already in the range.
+ */
+template <typename Range>
+auto reserve_more(Range& r, size_t n, true_type) -> void
+{
+  auto const max = r.max_size();
+  if (n > (max - r.size()))
+    return;
+  
+  auto const wanted = r.size() + n;
+  auto const capacity = r.capacity();
+  if (capacity >= wanted)
+    return;
+  
+  try
+  {
+    r.reserve((capacity > (max - capacity)) ? wanted : std::max(wanted, capacity * 2));
+  }
+  catch (length_error const&)
+  {}
+  catch (bad_alloc const&)
+  {}
+}
+
+template <typename Range>
+auto reserve_more(Range&, size_t, false_type) -> void
+{}
+
+//! The number of values read before estimating the number of values left.
+constexpr size_t estimate_sample_size = 64;
+
 /** Back inserting range input behaviour type.
  * 
  * \tparam Range     The range type being appended to.
@@ -28,19 +88,28 @@ namespace rangeio_detail {
 template <typename Range>
 struct back_insert_behaviour
 {
+  //! The type of the values read from the stream.
+  using value_type = value_type_of<Range>;
+  
   /** Constructs a back insert behaviour object.
    * 
-   * \param   n   The number of elements to read in a single read operation.
+   * \param   n         The number of elements to read in a single read
+   *                    operation.
+   * \param   estimate  Whether to reserve space for the number of
+   *                    elements estimated to be left in the stream.
    */
-  back_insert_behaviour(size_t n = numeric_limits<size_t>::max()) :
+  back_insert_behaviour(size_t n = numeric_limits<size_t>::max(), bool estimate = false) :
     v_{},
     n_{n},
-    current_{0}
+    current_{0},
+    estimate_{estimate}
   {}
   
   /** Prepares the input operation.
    * 
-   * Sets \c next to <tt>end(r)</tt>.
+   * Sets \c next to <tt>end(r)</tt>. If the number of elements to
+   * read is limited, and the range has a <tt>reserve()</tt> member
+   * function, space for that many more elements is reserved.
    * 
    * \param  r   The range being read into.
    * \param  i   Unused.
@@ -53,6 +122,10 @@ struct back_insert_behaviour
     tuple<bool, iterator_type_of<Range>>
   {
     current_ = 0;
+    
+    if (n_ != numeric_limits<size_t>::max())
+      reserve_more(r, n_, has_reserve<Range>{});
+    
     return make_tuple(true, end(r));
   }
   
@@ -61,9 +134,16 @@ struct back_insert_behaviour
    * Attempts to read a value from \a in and - if successful - uses
    * <tt>r.push_back()</tt> to move the value into the range.
    * 
-   * \param  in  The stream being read.
-   * \param  r   The range being read into.
-   * \param  i   Unused.
+   * If estimating, once the first few values have been read, the
+   * number of characters they took up and the number of characters
+   * left in the stream buffer (as reported by <tt>in_avail()</tt>,
+   * which for files is the rest of the file) give an estimate of
+   * the number of values left, which space is then reserved for.
+   * 
+   * \param  in      The stream being read.
+   * \param  r       The range being read into.
+   * \param  i       Unused.
+   * \param  source  The input source to read the value with.
    * 
    * \tparam CharT   The character type of the stream being read.
    * \tparam Traits  The character traits of the stream being read.
@@ -75,16 +155,105 @@ struct back_insert_behaviour
    *             - \c true if input succeeded, \c false otherwise.
    */
   template <typename CharT, typename Traits>
-  auto read(basic_istream<CharT, Traits>& in, Range& r, iterator_type_of<Range> i) ->
+  auto read(basic_istream<CharT, Traits>& in, Range& r, iterator_type_of<Range> i, input_source<CharT, Traits>& source) ->
     tuple<bool, iterator_type_of<Range>, bool, bool>
   {
-    if ((current_ < n_) && (in >> v_))
+    auto const result = read_bulk(in, r, i, source, 1);
+    
+    return make_tuple(get<0>(result), get<1>(result), get<2>(result) != 0, get<3>(result) != 0);
+  }
+  
+  /** Reads several values from the stream and appends them to the range.
+   * 
+   * Does what read() does, for up to \a max values.
+   * 
+   * \param  in      The stream being read.
+   * \param  r       The range being read into.
+   * \param  i       Unused.
+   * \param  source  The input source to read the values with.
+   * \param  max     The maximum number of values to read.
+   * 
+   * \tparam CharT   The character type of the stream being read.
+   * \tparam Traits  The character traits of the stream being read.
+   * 
+   * \return   A tuple containing:
+   *             - \c true if \a max values were read, and more can be,
+   *               \c false otherwise.
+   *             - <tt>end(r)</tt>.
+   *             - the number of values read.
+   *             - the number of values read.
+   */
+  template <typename CharT, typename Traits>
+  auto read_bulk(basic_istream<CharT, Traits>& in, Range& r, iterator_type_of<Range>, input_source<CharT, Traits>& source, size_t max) ->
+    tuple<bool, iterator_type_of<Range>, size_t, size_t>
+  {
+    if (estimate_ && (current_ == 0))
+      available_ = in.rdbuf()->in_avail();
+    
+    auto n = size_t{0};
+    
+    try
+    {
+      while ((n != max) && (current_ < n_) && source.extract(v_))
+      {
+        r.push_back(move(v_));
+        
+        if (estimate_ && ((current_ + 1) == estimate_sample_size))
+          reserve_estimate(in, r);
+        
+        ++current_;
+        ++n;
+      }
+    }
+    catch (...)
+    {
+      progress_ = make_tuple(end(r), n, n);
+      throw;
+    }
+    
+    return make_tuple((n == max) && (current_ < n_), end(r), n, n);
+  }
+  
+  /** Gets how far the last call to read_bulk() got before it threw.
+   * 
+   * \return   A tuple containing:
+   *             - the value that \c next should be set to.
+   *             - the number of values read.
+   *             - the number of values read.
+   */
+  auto progress_after_exception() ->
+    tuple<iterator_type_of<Range>, size_t, size_t>
+  {
+    return progress_;
+  }
+  
+  /** Reserves space for the number of values estimated to be left.
+   * 
+   * \param  in  The stream being read.
+   * \param  r   The range being read into.
+   */
+  template <typename CharT, typename Traits>
+  auto reserve_estimate(basic_istream<CharT, Traits>& in, Range& r) -> void
+  {
+    auto left = streamsize{0};
+    
+    try
+    {
+      left = in.rdbuf()->in_avail();
+    }
+    catch (...)
     {
-      r.push_back(move(v_));
-      return make_tuple(++current_ < n_, end(r), true, true);
+      handle_input_exception(in);
     }
     
-    return make_tuple(false, i, false, false);
+    auto const used = available_ - left;
+    if ((left <= 0) || (used <= 0))
+      return;
+    
+    // A little extra, so an estimate that is slightly short doesn't
+    // mean growing the range to twice the size at the end.
+    auto const n = static_cast<size_t>((left * static_cast<streamsize>(estimate_sample_size)) / used);
+    reserve_more(r, n + (n / 16), has_reserve<Range>{});
   }
   
   //! An instance of the range's value type, to use as a buffer for reading
@@ -96,6 +265,16 @@ struct back_insert_behaviour
   
   //! The number of elements read so far in the current read operation.
   size_t current_ = 0;
+  
+  //! Whether to reserve space for the elements estimated to be left.
+  bool estimate_ = false;
+  
+  //! The number of characters available at the start of the current
+  //! read operation.
+  streamsize available_ = 0;
+  
+  //! How far the last call to read_bulk() got, if it threw.
+  tuple<iterator_type_of<Range>, size_t, size_t> progress_;
 };
 
 } // namespace rangeio_detail
@@ -116,7 +295,33 @@ auto back_insert(Range& r) ->
   return input(r, end(r), rangeio_detail::back_insert_behaviour<Range>{});
 }
 
+/** Back insert range input function, reserving space for the values
+ * estimated to be left in the stream.
+ * 
+ * If the range has a <tt>reserve()</tt> member function, space is
+ * reserved for the number of values estimated to be left in the
+ * stream, once the first few have been read. The estimate is only
+ * made if the stream buffer can tell how many characters are left
+ * in it, as string and file stream buffers can.
+ * 
+ * \param   r   The range to write values to.
+ * 
+ * \tparam  Range     The range type to read into.
+ * 
+ * \return  A range input operation object for the given range, with the desired
+ *          behaviour.
+ */
+template <typename Range>
+auto back_insert(estimate_size_t, Range& r) ->
+  rangeio_detail::range_input_operation<Range, rangeio_detail::iterator_type_of<Range>, rangeio_detail::back_insert_behaviour<Range>>
+{
+  return input(r, end(r), rangeio_detail::back_insert_behaviour<Range>{numeric_limits<size_t>::max(), true});
+}
+
 /** Back insert range input function.
+ * 
+ * If the range has a <tt>reserve()</tt> member function, space for
+ * \a n more values is reserved up front.
  * 
  * \param   r   The range to write values to.
  * \param   n   The maximum number of values to read in a single input
@@ -0,0 +1,836 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STD_RANGEIO_direct_input_
+#define STD_RANGEIO_direct_input_
+
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <locale>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <system_error>
+#include <type_traits>
+
+#if __cplusplus >= 201703L
+#  include <charconv>
+#endif
+
+#include "range-traits.hpp"
+#include "stream-formatting-saver.hpp"
+
+// Numbers can only be parsed straight out of the stream buffer if the
+// library provides std::from_chars().
+#if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611L)
+#  define STD_RANGEIO_HAVE_FROM_CHARS
+#endif
+
+namespace std {
+namespace rangeio_detail {
+
+/** Handles an exception thrown while reading from a stream.
+ * 
+ * Does what the standard formatted input functions do: sets
+ * \c badbit on the stream, and rethrows the exception if the stream's
+ * exception mask includes \c badbit . Must be called from within a
+ * \c catch block.
+ * 
+ * \param  in  The stream being read.
+ */
+template <typename CharT, typename Traits>
+auto handle_input_exception(basic_istream<CharT, Traits>& in) -> void
+{
+  try
+  {
+    in.setstate(ios_base::badbit);
+  }
+  catch (ios_base::failure const&)
+  {}
+  
+  if (in.exceptions() & ios_base::badbit)
+    throw;
+}
+
+/** Helper template to detect the types read with \c num_get .
+ * 
+ * These are the arithmetic types other than the character types,
+ * which the standard extractors read with the stream's \c num_get
+ * facet.
+ * 
+ * \tparam T  The type to check.
+ */
+template <typename T>
+struct is_num_get_readable :
+  integral_constant<bool, is_arithmetic<T>::value && !is_character<T>::value>
+{};
+
+/** Finds the bytes in a given range in eight ASCII bytes at once.
+ * 
+ * Each byte is compared in its own lane of a 64 bit integer. The
+ * low seven bits of each byte are offset so that the lane's top bit
+ * says whether they are at least \a lo (or \a hi ); there is no
+ * carry between lanes, so the result is exact. Bytes with their top
+ * bit set are never in the range.
+ * 
+ * \param  x   Eight bytes.
+ * \param  lo  The lowest byte value in the range. Must be at least 1.
+ * \param  hi  One past the highest byte value in the range. Must be
+ *             at most 128.
+ * 
+ * \return   A mask with the top bit of each byte in the range set.
+ */
+inline auto bytes_in_range(uint64_t x, unsigned lo, unsigned hi) -> uint64_t
+{
+  auto const ones = uint64_t{0x0101010101010101u};
+  auto const low_bits = x & (ones * 0x7Fu);
+  auto const at_least_lo = low_bits + ones * (0x80u - lo);
+  auto const at_least_hi = low_bits + ones * (0x80u - hi);
+  
+  return at_least_lo & ~at_least_hi & ~x & (ones * 0x80u);
+}
+
+/** Skips the "C" locale whitespace at the start of a character
+ * sequence.
+ * 
+ * The sequence is scanned eight characters at a time, until a block
+ * with something other than whitespace in it is found.
+ * 
+ * \param  first  The first character.
+ * \param  last   One past the last character.
+ * 
+ * \return   The first character that isn't whitespace, or \a last .
+ */
+inline auto skip_whitespace(char const* first, char const* last) -> char const*
+{
+  auto const all = uint64_t{0x8080808080808080u};
+  
+  for (auto x = uint64_t{}; (last - first) >= 8; first += 8)
+  {
+    memcpy(&x, first, 8);
+    
+    if ((bytes_in_range(x, '\t', '\r' + 1) | bytes_in_range(x, ' ', ' ' + 1)) != all)
+      break;
+  }
+  
+  while ((first != last) && ((*first == ' ') || (static_cast<unsigned char>(*first - '\t') <= '\r' - '\t')))
+    ++first;
+  
+  return first;
+}
+
+/** Skips the decimal digits at the start of a character sequence.
+ * 
+ * The sequence is scanned eight characters at a time, until a block
+ * with something other than digits in it is found.
+ * 
+ * \param  first  The first character.
+ * \param  last   One past the last character.
+ * 
+ * \return   The first character that isn't a digit, or \a last .
+ */
+inline auto skip_digits(char const* first, char const* last) -> char const*
+{
+  auto const all = uint64_t{0x8080808080808080u};
+  
+  for (auto x = uint64_t{}; (last - first) >= 8; first += 8)
+  {
+    memcpy(&x, first, 8);
+    
+    if (bytes_in_range(x, '0', '9' + 1) != all)
+      break;
+  }
+  
+  while ((first != last) && (static_cast<unsigned char>(*first - '0') < 10u))
+    ++first;
+  
+  return first;
+}
+
+/** Skips the characters at the start of a character sequence that
+ * aren't "C" locale whitespace.
+ * 
+ * The sequence is scanned eight characters at a time, until a block
+ * with whitespace in it is found.
+ * 
+ * \param  first  The first character.
+ * \param  last   One past the last character.
+ * 
+ * \return   The first whitespace character, or \a last .
+ */
+inline auto skip_token(char const* first, char const* last) -> char const*
+{
+  for (auto x = uint64_t{}; (last - first) >= 8; first += 8)
+  {
+    memcpy(&x, first, 8);
+    
+    if (bytes_in_range(x, '\t', '\r' + 1) | bytes_in_range(x, ' ', ' ' + 1))
+      break;
+  }
+  
+  while ((first != last) && (*first != ' ') && (static_cast<unsigned char>(*first - '\t') > '\r' - '\t'))
+    ++first;
+  
+  return first;
+}
+
+/** Finds the end of a decimal integer that can be parsed with
+ * \c from_chars() exactly as \c num_get would parse it.
+ * 
+ * That is some digits, preceded by a minus sign for signed types.
+ * 
+ * \param  first  The first character.
+ * \param  last   One past the last character.
+ * 
+ * \return   One past the last character of the integer, or \c nullptr
+ *           if it isn't one.
+ */
+template <typename T>
+auto scan_number(char const* first, char const* last, true_type) -> char const*
+{
+  if (is_signed<T>::value && (first != last) && (*first == '-'))
+    ++first;
+  
+  auto const p = skip_digits(first, last);
+  
+  return (p != first) ? p : nullptr;
+}
+
+/** Finds the end of a floating point number that can be parsed with
+ * \c from_chars() exactly as \c num_get would parse it.
+ * 
+ * That is an optional minus sign, some digits with an optional
+ * decimal point among or after them, and an optional exponent with
+ * an optional sign. If anything that \c num_get would take as part
+ * of the exponent follows the number, it isn't one, because
+ * \c num_get fails on an exponent without digits.
+ * 
+ * \param  first  The first character.
+ * \param  last   One past the last character.
+ * 
+ * \return   One past the last character of the number, or \c nullptr
+ *           if it isn't one.
+ */
+template <typename T>
+auto scan_number(char const* first, char const* last, false_type) -> char const*
+{
+  if ((first != last) && (*first == '-'))
+    ++first;
+  
+  auto p = skip_digits(first, last);
+  auto digits = p - first;
+  
+  if ((p != last) && (*p == '.'))
+  {
+    auto const fraction = p + 1;
+    p = skip_digits(fraction, last);
+    digits += p - fraction;
+  }
+  
+  if (!digits)
+    return nullptr;
+  
+  if ((p != last) && ((*p == 'e') || (*p == 'E')))
+  {
+    ++p;
+    if ((p != last) && ((*p == '+') || (*p == '-')))
+      ++p;
+    
+    auto const exponent = p;
+    p = skip_digits(exponent, last);
+    
+    if (p == exponent)
+      return nullptr;
+  }
+  
+  return p;
+}
+
+/** Access to the get area of a stream buffer.
+ * 
+ * The get area pointers are protected members of \c basic_streambuf ,
+ * but a derived class can name them, and the resulting member
+ * pointers can be used with any stream buffer. No objects of this
+ * class are ever created.
+ * 
+ * \tparam CharT   The character type of the stream buffer.
+ * \tparam Traits  The character traits of the stream buffer.
+ */
+template <typename CharT, typename Traits>
+struct get_area :
+  basic_streambuf<CharT, Traits>
+{
+  using streambuf_type = basic_streambuf<CharT, Traits>;
+  
+  //! The next character available in the get area of \a b .
+  static auto begin(streambuf_type& b) -> CharT*
+  {
+    return (b.*&get_area::gptr)();
+  }
+  
+  //! One past the last character available in the get area of \a b .
+  static auto end(streambuf_type& b) -> CharT*
+  {
+    return (b.*&get_area::egptr)();
+  }
+  
+  //! Consumes the characters in the get area of \a b up to \a p .
+  static auto consume(streambuf_type& b, CharT const* p) -> void
+  {
+    (b.*&get_area::gbump)(static_cast<int>(p - begin(b)));
+  }
+};
+
+/** Flushes the stream tied to an input stream once, for a whole
+ * input operation.
+ * 
+ * Every sentry flushes the tied stream, which - for \c cin tied to
+ * \c cout - means a flush for every value read. This flushes the
+ * tied stream up front, just as the first sentry would, then unties
+ * the stream until it is destroyed, so the sentries of the
+ * extractors used during the operation don't flush it again.
+ * 
+ * \tparam CharT   The character type of the stream.
+ * \tparam Traits  The character traits of the stream.
+ */
+template <typename CharT, typename Traits>
+struct tie_flusher
+{
+  explicit tie_flusher(basic_istream<CharT, Traits>& in) :
+    in_{in},
+    tie_{in.tie()}
+  {
+    if (tie_ && in_.good())
+      tie_->flush();
+    
+    in_.tie(nullptr);
+  }
+  
+  ~tie_flusher()
+  {
+    in_.tie(tie_);
+  }
+  
+  tie_flusher(tie_flusher const&) = delete;
+  auto operator=(tie_flusher const&) -> tie_flusher& = delete;
+  
+  basic_istream<CharT, Traits>& in_;
+  basic_ostream<CharT, Traits>* const tie_;
+};
+
+/** Source of values for a range input operation.
+ * 
+ * One of these is created for every input operation, and passed to
+ * the input behaviour, which uses it to read values. It looks up
+ * the stream's \c num_get facet once, the first time an arithmetic
+ * value is read, and then calls it directly for every arithmetic
+ * value - which is exactly what the standard extractors do, minus
+ * the facet lookup. Values of any other type are read with their
+ * extractors, so streams that have no \c num_get facet - those with
+ * non-standard character traits - can still read them.
+ * 
+ * The formatting state of the stream is restored before every value
+ * is read, so behaviours that read several values at once get the
+ * same formatting for each of them.
+ * 
+ * Arithmetic values are read without a sentry. The state checks and
+ * whitespace skipping the sentry would do are done here instead, and
+ * the tied stream is flushed once for the whole input operation (see
+ * \c tie_flusher ) rather than once for every value.
+ * 
+ * In the "C" locale, narrow streams skip whitespace before numbers
+ * straight out of the get area, several characters at a time,
+ * rather than classifying them one by one with the \c ctype facet.
+ * Decimal integers, floats and doubles in the "C" locale are also
+ * parsed straight out of the get area of narrow stream buffers with
+ * \c from_chars() , when the whole number is there. That gives the
+ * same correctly rounded result as the \c strtod() behind
+ * \c num_get . Anything that needs more care - a plus sign, an
+ * unsigned value with a minus sign, a value out of range, a
+ * malformed exponent, or a number that may continue past the end of
+ * the get area - is left to \c num_get , which then reads it from
+ * the start.
+ * 
+ * When the input operation recovers from malformed values (see
+ * \c recovering() ), input is taken a whitespace delimited token at a
+ * time: a value that isn't followed by whitespace or the end of the
+ * stream fails to read, and the stream position at which each token
+ * starts is asked for before it is read, until all the positions
+ * wanted have been recorded.
+ * 
+ * \tparam CharT   The character type of the stream.
+ * \tparam Traits  The character traits of the stream.
+ */
+template <typename CharT, typename Traits>
+struct input_source
+{
+  using facet_type = num_get<CharT, istreambuf_iterator<CharT, Traits>>;
+  
+  input_source(basic_istream<CharT, Traits>& in, stream_formatting_saver<CharT, Traits> const& formatting) :
+    in_{in},
+    formatting_{formatting},
+    ctype_{use_facet<ctype<CharT>>(in.getloc())},
+    classic_{in.getloc() == locale::classic()}
+  {}
+  
+  /** Reads a value from the stream.
+   * 
+   * \param  v   The object to read into.
+   * 
+   * \return   \c true if the value was read successfully.
+   */
+  template <typename T>
+  auto extract(T& v) -> bool
+  {
+    formatting_.template restore_for<T>();
+    marked_ = false;
+    extract(v, is_num_get_readable<T>{});
+    
+    if (recovering_ && !is_character<T>::value && !in_.fail())
+      check_token_end();
+    
+    return !in_.fail();
+  }
+  
+  template <typename T>
+  auto extract(T& v, false_type) -> void
+  {
+    if (marking_)
+    {
+      if (in_.flags() & ios_base::skipws)
+        in_ >> ws;
+      
+      try
+      {
+        mark_token();
+      }
+      catch (...)
+      {
+        handle_input_exception(in_);
+      }
+    }
+    
+    in_ >> v;
+  }
+  
+  /** Reads an arithmetic value from the stream.
+   * 
+   * This does the work of the sentry itself - checking the stream
+   * state and skipping whitespace - but doesn't flush the tied
+   * stream; that is done once for the whole input operation.
+   */
+  template <typename T>
+  auto extract(T& v, true_type) -> void
+  {
+    if (!in_.good())
+    {
+      in_.setstate(ios_base::failbit);
+      return;
+    }
+    
+    auto err = ios_base::iostate{ios_base::goodbit};
+    
+    try
+    {
+      if (!(in_.flags() & ios_base::skipws) || skip_whitespace(err, is_same<CharT, char>{}))
+      {
+        mark_token();
+        get(v, err);
+      }
+    }
+    catch (...)
+    {
+      handle_input_exception(in_);
+    }
+    
+    if (err)
+      in_.setstate(err);
+  }
+  
+  /** Skips a value in the stream, without reading it.
+   * 
+   * Only for types whose text form is whitespace delimited: the
+   * value is taken to be everything up to the next whitespace, which
+   * is skipped without being parsed. If the stream's width is set or
+   * it doesn't skip whitespace, the token can't be found that way,
+   * so a value is read and thrown away instead.
+   * 
+   * \tparam T   The type of the value.
+   * 
+   * \return   \c true if a value was skipped successfully.
+   */
+  template <typename T>
+  auto skip() -> bool
+  {
+    formatting_.template restore_for<T>();
+    
+    if (in_.width() || !(in_.flags() & ios_base::skipws))
+    {
+      auto v = T{};
+      extract(v, is_num_get_readable<T>{});
+    }
+    else if (!in_.good())
+    {
+      in_.setstate(ios_base::failbit);
+    }
+    else
+    {
+      auto err = ios_base::iostate{ios_base::goodbit};
+      
+      try
+      {
+        if (skip_whitespace(err, is_same<CharT, char>{}))
+          skip_token(err, is_same<CharT, char>{});
+      }
+      catch (...)
+      {
+        handle_input_exception(in_);
+      }
+      
+      if (err)
+        in_.setstate(err);
+    }
+    
+    return !in_.fail();
+  }
+  
+  /** Records the stream position at which the next value starts, if
+   * positions are wanted.
+   */
+  auto mark_token() -> void
+  {
+    if (!marking_)
+      return;
+    
+    token_start_ = streamoff(in_.rdbuf()->pubseekoff(0, ios_base::cur, ios_base::in));
+    marked_ = true;
+  }
+  
+  /** Fails the value just read if it isn't followed by whitespace or
+   * the end of the stream, so that the rest of its token isn't taken
+   * for the next value.
+   */
+  auto check_token_end() -> void
+  {
+    auto malformed = false;
+    
+    try
+    {
+      auto const c = in_.rdbuf()->sgetc();
+      malformed = !Traits::eq_int_type(c, Traits::eof()) && !ctype_.is(ctype_base::space, Traits::to_char_type(c));
+    }
+    catch (...)
+    {
+      handle_input_exception(in_);
+    }
+    
+    if (malformed)
+      in_.setstate(ios_base::failbit);
+  }
+  
+  /** Skips the rest of a value that failed to read.
+   * 
+   * Everything up to the next whitespace is skipped. If the stream
+   * is already at whitespace - the value having been cut short by
+   * it - that one character is skipped instead, so that input always
+   * moves on.
+   */
+  auto skip_malformed() -> void
+  {
+    auto& buf = *in_.rdbuf();
+    auto err = ios_base::iostate{ios_base::goodbit};
+    
+    try
+    {
+      auto const c = buf.sgetc();
+      
+      if (Traits::eq_int_type(c, Traits::eof()))
+        err |= ios_base::eofbit;
+      else if (ctype_.is(ctype_base::space, Traits::to_char_type(c)))
+        buf.sbumpc();
+      else
+        skip_token(err, is_same<CharT, char>{});
+    }
+    catch (...)
+    {
+      handle_input_exception(in_);
+    }
+    
+    if (err)
+      in_.setstate(err);
+  }
+  
+  /** Skips everything up to the next whitespace in the stream, a get
+   * area at a time.
+   * 
+   * \param  err  Set to \c eofbit if the end of the stream is
+   *              reached.
+   */
+  auto skip_token(ios_base::iostate& err, true_type) -> void
+  {
+    if (!classic_)
+      return skip_token(err, false_type{});
+    
+    auto& buf = *in_.rdbuf();
+    
+    while (true)
+    {
+      auto const first = get_area<CharT, Traits>::begin(buf);
+      auto const last = get_area<CharT, Traits>::end(buf);
+      auto const p = rangeio_detail::skip_token(first, last);
+      
+      get_area<CharT, Traits>::consume(buf, p);
+      if (p != last)
+        return;
+      
+      // As for whitespace, an empty get area means going one
+      // character at a time.
+      auto const c = buf.sgetc();
+      if (Traits::eq_int_type(c, Traits::eof()))
+      {
+        err |= ios_base::eofbit;
+        return;
+      }
+      
+      if (first == last)
+      {
+        auto const ch = Traits::to_char_type(c);
+        if ((ch == ' ') || (static_cast<unsigned char>(ch - '\t') <= '\r' - '\t'))
+          return;
+        
+        buf.sbumpc();
+      }
+    }
+  }
+  
+  /** Skips everything up to the next whitespace in the stream, one
+   * character at a time.
+   */
+  auto skip_token(ios_base::iostate& err, false_type) -> void
+  {
+    auto& buf = *in_.rdbuf();
+    
+    for (auto c = buf.sgetc(); ; c = buf.snextc())
+    {
+      if (Traits::eq_int_type(c, Traits::eof()))
+      {
+        err |= ios_base::eofbit;
+        return;
+      }
+      
+      if (ctype_.is(ctype_base::space, Traits::to_char_type(c)))
+        return;
+    }
+  }
+  
+  /** Skips whitespace in the stream, a get area at a time.
+   * 
+   * Only the "C" locale whitespace is skipped this way; in any other
+   * locale, whitespace is skipped with the \c ctype facet.
+   * 
+   * \param  err  Set to \c eofbit and \c failbit if the end of the
+   *              stream is reached, as the sentry would.
+   * 
+   * \return   \c true if there is something other than whitespace
+   *           to read.
+   */
+  auto skip_whitespace(ios_base::iostate& err, true_type) -> bool
+  {
+    if (!classic_)
+      return skip_whitespace(err, false_type{});
+    
+    auto& buf = *in_.rdbuf();
+    
+    while (true)
+    {
+      auto const first = get_area<CharT, Traits>::begin(buf);
+      auto const last = get_area<CharT, Traits>::end(buf);
+      auto const p = rangeio_detail::skip_whitespace(first, last);
+      
+      if (p != last)
+      {
+        get_area<CharT, Traits>::consume(buf, p);
+        return true;
+      }
+      
+      // Either the get area was all whitespace, or there is no get
+      // area; consume whatever there was one character at a time,
+      // so unbuffered stream buffers work too.
+      get_area<CharT, Traits>::consume(buf, last);
+      
+      auto const c = buf.sgetc();
+      if (Traits::eq_int_type(c, Traits::eof()))
+      {
+        err |= ios_base::eofbit | ios_base::failbit;
+        return false;
+      }
+      
+      if (first == last)
+      {
+        auto const ch = Traits::to_char_type(c);
+        if ((ch != ' ') && (static_cast<unsigned char>(ch - '\t') > '\r' - '\t'))
+          return true;
+        
+        buf.sbumpc();
+      }
+    }
+  }
+  
+  /** Skips whitespace in the stream, one character at a time.
+   * 
+   * This is exactly what the sentry does.
+   */
+  auto skip_whitespace(ios_base::iostate& err, false_type) -> bool
+  {
+    auto& buf = *in_.rdbuf();
+    
+    for (auto c = buf.sgetc(); ; c = buf.snextc())
+    {
+      if (Traits::eq_int_type(c, Traits::eof()))
+      {
+        err |= ios_base::eofbit | ios_base::failbit;
+        return false;
+      }
+      
+      if (!ctype_.is(ctype_base::space, Traits::to_char_type(c)))
+        return true;
+    }
+  }
+  
+  template <typename T>
+  auto get(T& v, ios_base::iostate& err) -> void
+  {
+    using parsable = integral_constant<bool, is_same<CharT, char>::value &&
+      ((is_integral<T>::value && !is_same<T, bool>::value) || is_same<T, float>::value || is_same<T, double>::value)>;
+    
+    if (!parse(v, parsable{}))
+      num_get_facet().get(istreambuf_iterator<CharT, Traits>{in_}, istreambuf_iterator<CharT, Traits>{}, in_, err, v);
+  }
+  
+  //! The stream's \c num_get facet, looked up the first time it is
+  //! needed.
+  auto num_get_facet() -> facet_type const&
+  {
+    if (!facet_)
+      facet_ = addressof(use_facet<facet_type>(in_.getloc()));
+    
+    return *facet_;
+  }
+  
+  /** Parses a number straight out of the get area, if possible.
+   * 
+   * \param  v   The object to read into.
+   * 
+   * \return   \c true if the number was parsed, \c false if nothing
+   *           was consumed and the number has to be read with
+   *           \c num_get .
+   */
+  template <typename T>
+  auto parse(T& v, true_type) -> bool
+  {
+#ifdef STD_RANGEIO_HAVE_FROM_CHARS
+    if (!classic_ || (is_integral<T>::value && ((in_.flags() & ios_base::basefield) != ios_base::dec)))
+      return false;
+    
+    auto& buf = *in_.rdbuf();
+    auto const first = get_area<CharT, Traits>::begin(buf);
+    auto const last = get_area<CharT, Traits>::end(buf);
+    auto const p = scan_number<T>(first, last, is_integral<T>{});
+    
+    // If the number runs up to the end of the get area, there may be
+    // more of it in the next buffer.
+    if (!p || (p == last))
+      return false;
+    
+    if (from_chars(first, p, v).ec != errc{})
+      return false;
+    
+    get_area<CharT, Traits>::consume(buf, p);
+    
+    return true;
+#else
+    static_cast<void>(v);
+    return false;
+#endif
+  }
+  
+  template <typename T>
+  auto parse(T&, false_type) -> bool
+  {
+    return false;
+  }
+  
+  // There are no num_get overloads for short and int, so - just like
+  // the extractors - they are read as long and range checked.
+  auto get(short& v, ios_base::iostate& err) -> void
+  {
+    get_narrowed(v, err);
+  }
+  
+  auto get(int& v, ios_base::iostate& err) -> void
+  {
+    get_narrowed(v, err);
+  }
+  
+  template <typename T>
+  auto get_narrowed(T& v, ios_base::iostate& err) -> void
+  {
+    auto l = long{};
+    get(l, err);
+    
+    if (l < long{numeric_limits<T>::min()})
+    {
+      err |= ios_base::failbit;
+      v = numeric_limits<T>::min();
+    }
+    else if (l > long{numeric_limits<T>::max()})
+    {
+      err |= ios_base::failbit;
+      v = numeric_limits<T>::max();
+    }
+    else
+    {
+      v = static_cast<T>(l);
+    }
+  }
+  
+  basic_istream<CharT, Traits>& in_;
+  stream_formatting_saver<CharT, Traits> const& formatting_;
+  facet_type const* facet_ = nullptr;
+  ctype<CharT> const& ctype_;
+  bool const classic_;
+  
+  //! Whether values must take up whole whitespace delimited tokens.
+  bool recovering_ = false;
+  
+  //! Whether to record the stream position at which each value starts.
+  bool marking_ = false;
+  
+  //! Whether \c token_start_ was recorded for the last value read.
+  bool marked_ = false;
+  
+  //! The stream position at which the last value read started, or -1
+  //! if the stream buffer can't tell.
+  streamoff token_start_ = -1;
+};
+
+} // namespace rangeio_detail
+} // namespace std
+
+#endif  // STD_RANGEIO_direct_input_
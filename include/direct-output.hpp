@@ -0,0 +1,1368 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STD_RANGEIO_direct_output_
+#define STD_RANGEIO_direct_output_
+
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <ios>
+#include <iterator>
+#include <limits>
+#include <locale>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+
+#include "range-traits.hpp"
+#include "stream-formatting-saver.hpp"
+
+#if __cplusplus >= 201703L
+#  include <charconv>
+#endif
+
+// Floating point values can only be formatted directly if the library
+// provides std::to_chars() for them.
+#if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611L)
+#  define STD_RANGEIO_HAVE_TO_CHARS
+#endif
+
+namespace std {
+namespace rangeio_detail {
+
+/** The formatting state used when writing values directly.
+ * 
+ * This is a snapshot of the formatting state of a stream (as
+ * captured by \c stream_formatting_saver ), which is applied to
+ * every element of the range.
+ * 
+ * \tparam CharT   The character type of the stream.
+ */
+template <typename CharT>
+struct output_format
+{
+  ios_base::fmtflags flags;
+  streamsize width;
+  streamsize precision;
+  CharT fill;
+  
+  //! Floating point values are written in the shortest form that
+  //! round-trips, ignoring the precision.
+  bool shortest;
+};
+
+/** Captures the formatting state saved by a stream formatting saver.
+ * 
+ * \param  s          The stream formatting saver.
+ * \param  shortest   Whether floating point values are written in
+ *                    the shortest form that round-trips.
+ * 
+ * \return   The saved formatting state.
+ */
+template <typename CharT, typename Traits>
+auto output_format_of(stream_formatting_saver<CharT, Traits> const& s, bool shortest) ->
+  output_format<CharT>
+{
+  return {s.flags_, s.width_, s.precision_, s.fill_, shortest};
+}
+
+/** Output sink that writes to a stream buffer.
+ * 
+ * Everything is written straight to the stream buffer, so every
+ * element is complete in the stream buffer as soon as it ends.
+ * 
+ * \tparam CharT   The character type of the stream buffer.
+ * \tparam Traits  The character traits of the stream buffer.
+ */
+template <typename CharT, typename Traits>
+struct streambuf_sink
+{
+  using traits_type = Traits;
+  
+  explicit streambuf_sink(basic_streambuf<CharT, Traits>& buf) :
+    buf_{buf}
+  {}
+  
+  /** Writes \a n characters from \a s to the stream buffer.
+   * 
+   * \return   \c true if all characters were written.
+   */
+  auto put(CharT const* s, streamsize n) -> bool
+  {
+    return buf_.sputn(s, n) == n;
+  }
+  
+  /** Writes the character \a c to the stream buffer.
+   * 
+   * \return   \c true if the character was written.
+   */
+  auto put(CharT c) -> bool
+  {
+    return !Traits::eq_int_type(buf_.sputc(c), Traits::eof());
+  }
+  
+  /** Writes \a n copies of \a c to the stream buffer.
+   * 
+   * \return   \c true if all characters were written.
+   */
+  auto fill(CharT c, streamsize n) -> bool
+  {
+    for (; n > 0; --n)
+    {
+      if (Traits::eq_int_type(buf_.sputc(c), Traits::eof()))
+        return false;
+    }
+    
+    return true;
+  }
+  
+  /** Marks the end of an element.
+   * 
+   * \return   \c true .
+   */
+  auto end_element() -> bool
+  {
+    ++committed_;
+    return true;
+  }
+  
+  /** Does nothing; there is nothing to flush.
+   * 
+   * \return   \c true .
+   */
+  auto flush() -> bool
+  {
+    return true;
+  }
+  
+  /** The number of elements that are complete in the stream buffer. */
+  auto committed() const -> size_t
+  {
+    return committed_;
+  }
+  
+  basic_streambuf<CharT, Traits>& buf_;
+  size_t committed_ = 0;
+};
+
+/** Output sink that stages output in a local buffer.
+ * 
+ * Everything written is collected in a fixed-size buffer, which is
+ * written to the stream buffer with a single \c sputn() whenever it
+ * fills up, and when it is flushed at the end - so the stream
+ * buffer sees a few large writes instead of several small ones per
+ * element. Output too large for the buffer is written straight
+ * through.
+ * 
+ * The ends of the elements in the buffer are recorded, so that if
+ * the stream buffer only takes part of the buffer, the elements
+ * that made it there completely can still be counted.
+ * 
+ * \tparam CharT   The character type of the stream buffer.
+ * \tparam Traits  The character traits of the stream buffer.
+ */
+template <typename CharT, typename Traits>
+struct staging_sink
+{
+  using traits_type = Traits;
+  
+  //! The size of the buffer, in characters.
+  static constexpr streamsize capacity = 8192 / sizeof(CharT);
+  
+  //! The maximum number of element ends recorded between flushes.
+  static constexpr size_t max_pending = 512;
+  
+  explicit staging_sink(basic_streambuf<CharT, Traits>& buf) :
+    buf_{buf}
+  {}
+  
+  /** Writes \a n characters from \a s to the buffer.
+   * 
+   * \return   \c true if the buffer had to be flushed, and that
+   *           succeeded, or if it didn't need to be.
+   */
+  auto put(CharT const* s, streamsize n) -> bool
+  {
+    if (n > (capacity - size_))
+    {
+      if (!flush())
+        return false;
+      
+      if (n > capacity)
+        return buf_.sputn(s, n) == n;
+    }
+    
+    Traits::copy(buffer_ + size_, s, static_cast<size_t>(n));
+    size_ += n;
+    
+    return true;
+  }
+  
+  /** Writes the character \a c to the buffer.
+   * 
+   * \return   \c true if the buffer had to be flushed, and that
+   *           succeeded, or if it didn't need to be.
+   */
+  auto put(CharT c) -> bool
+  {
+    if ((size_ == capacity) && !flush())
+      return false;
+    
+    Traits::assign(buffer_[size_++], c);
+    
+    return true;
+  }
+  
+  /** Writes \a n copies of \a c to the buffer.
+   * 
+   * \return   \c true if the buffer had to be flushed, and that
+   *           succeeded, or if it didn't need to be.
+   */
+  auto fill(CharT c, streamsize n) -> bool
+  {
+    while (n > 0)
+    {
+      if ((size_ == capacity) && !flush())
+        return false;
+      
+      auto const k = (n < (capacity - size_)) ? n : (capacity - size_);
+      Traits::assign(buffer_ + size_, static_cast<size_t>(k), c);
+      size_ += k;
+      n -= k;
+    }
+    
+    return true;
+  }
+  
+  /** Marks the end of an element.
+   * 
+   * \return   \c true if the buffer had to be flushed, and that
+   *           succeeded, or if it didn't need to be.
+   */
+  auto end_element() -> bool
+  {
+    ends_[pending_++] = size_;
+    
+    return (pending_ != max_pending) || flush();
+  }
+  
+  /** Writes the buffer to the stream buffer.
+   * 
+   * \return   \c true if everything was written.
+   */
+  auto flush() -> bool
+  {
+    auto const written = size_ ? buf_.sputn(buffer_, size_) : streamsize{0};
+    
+    if (written != size_)
+    {
+      for (auto i = size_t{0}; (i != pending_) && (ends_[i] <= written); ++i)
+        ++committed_;
+      
+      pending_ = 0;
+      size_ = 0;
+      
+      return false;
+    }
+    
+    committed_ += pending_;
+    pending_ = 0;
+    size_ = 0;
+    
+    return true;
+  }
+  
+  /** The number of elements that are complete in the stream buffer. */
+  auto committed() const -> size_t
+  {
+    return committed_;
+  }
+  
+  basic_streambuf<CharT, Traits>& buf_;
+  streamsize size_ = 0;
+  size_t pending_ = 0;
+  size_t committed_ = 0;
+  streamsize ends_[max_pending];
+  CharT buffer_[capacity];
+};
+
+/** Helper template to select the sink for writing a sequence directly.
+ * 
+ * The output is staged, unless the sequence can only be traversed
+ * once - if an element staged but not written has to be reported
+ * as the next element, the sequence has to be traversed again to
+ * get to it.
+ * 
+ * \tparam Iterator  The iterator type of the sequence.
+ * \tparam CharT     The character type of the stream buffer.
+ * \tparam Traits    The character traits of the stream buffer.
+ */
+template <typename Iterator, typename CharT, typename Traits>
+using direct_sink_of = typename conditional<
+  is_base_of<forward_iterator_tag, typename iterator_traits<Iterator>::iterator_category>::value,
+  staging_sink<CharT, Traits>,
+  streambuf_sink<CharT, Traits>>::type;
+
+/** Writes a formatted value to a sink, applying padding.
+ * 
+ * This follows the padding rules of the standard inserters: if the
+ * width is greater than the length of the value, fill characters
+ * are added after the value for left adjustment, after the first
+ * \a internal characters (the sign or base prefix) for internal
+ * adjustment, and before the value otherwise.
+ * 
+ * \param  sink      The sink to write to.
+ * \param  s         The formatted value.
+ * \param  n         The length of the formatted value.
+ * \param  internal  The position to pad at for internal adjustment.
+ * \param  f         The formatting state.
+ * 
+ * \return   \c true if everything was written.
+ */
+template <typename CharT, typename Sink>
+auto put_padded(Sink& sink, CharT const* s, streamsize n, streamsize internal, output_format<CharT> const& f) -> bool
+{
+  if (f.width <= n)
+    return sink.put(s, n);
+  
+  auto const padding = f.width - n;
+  auto const adjust = f.flags & ios_base::adjustfield;
+  
+  if (adjust == ios_base::left)
+    return sink.put(s, n) && sink.fill(f.fill, padding);
+  
+  auto const split = (adjust == ios_base::internal) ? internal : streamsize{0};
+  
+  return sink.put(s, split) && sink.fill(f.fill, padding) && sink.put(s + split, n - split);
+}
+
+/** Writes a number formatted in the "C" locale to a sink.
+ * 
+ * The characters are widened to the stream character type, and
+ * padded exactly as \c num_put would pad them - for internal
+ * adjustment, after the sign or the "0x" base prefix.
+ * 
+ * \param  sink   The sink to write to.
+ * \param  first  The beginning of the formatted number.
+ * \param  last   The end of the formatted number.
+ * \param  f      The formatting state.
+ * 
+ * \return   \c true if everything was written.
+ */
+template <typename CharT, typename Sink>
+auto put_number(Sink& sink, char const* first, char const* last, output_format<CharT> const& f) -> bool
+{
+  auto const n = static_cast<streamsize>(last - first);
+  
+  auto internal = streamsize{0};
+  if (n > 0 && (first[0] == '-' || first[0] == '+'))
+    internal = 1;
+  else if (n > 1 && first[0] == '0' && (first[1] == 'x' || first[1] == 'X'))
+    internal = 2;
+  
+  // In the "C" locale, widening the basic characters is a plain
+  // conversion, so there is no need to consult the ctype facet.
+  CharT buffer[128];
+  auto heap = unique_ptr<CharT[]>{};
+  auto s = buffer;
+  
+  if (n > streamsize(sizeof(buffer) / sizeof(buffer[0])))
+  {
+    heap.reset(new CharT[n]);
+    s = heap.get();
+  }
+  
+  for (auto i = streamsize{0}; i < n; ++i)
+    s[i] = static_cast<CharT>(first[i]);
+  
+  return put_padded(sink, static_cast<CharT const*>(s), n, internal, f);
+}
+
+template <typename Sink>
+auto put_number(Sink& sink, char const* first, char const* last, output_format<char> const& f) -> bool
+{
+  auto const n = static_cast<streamsize>(last - first);
+  
+  auto internal = streamsize{0};
+  if (n > 0 && (first[0] == '-' || first[0] == '+'))
+    internal = 1;
+  else if (n > 1 && first[0] == '0' && (first[1] == 'x' || first[1] == 'X'))
+    internal = 2;
+  
+  return put_padded(sink, first, n, internal, f);
+}
+
+/** Checks whether a stream's numeric formatting can be done directly.
+ * 
+ * Direct formatting reproduces the behaviour of \c num_put in the
+ * classic "C" locale, for narrow and wide character streams.
+ * 
+ * \param  s   The stream to check.
+ * 
+ * \return   \c true if the stream uses the classic locale and a
+ *           standard character type.
+ */
+template <typename CharT, typename Traits>
+auto is_classic_numeric_format(basic_ios<CharT, Traits> const& s) -> bool
+{
+  return (is_same<CharT, char>::value || is_same<CharT, wchar_t>::value) &&
+    (s.getloc() == locale::classic());
+}
+
+/** Writes exactly eight decimal digits.
+ * 
+ * All eight digits are computed at once in the lanes of a 64 bit
+ * integer: the value is split into two four digit halves, those
+ * into two digit pairs, and those into single digits, with every
+ * division done by multiplying with a fixed point reciprocal that
+ * is exact for the range of values in each lane.
+ * 
+ * \param  p   The buffer to write the digits to.
+ * \param  v   The value to write. Must be less than 100000000;
+ *             leading zeros are written.
+ */
+inline auto encode_eight_digits(char* p, uint32_t v) -> void
+{
+  auto const merged = uint64_t{v / 10000u} | (uint64_t{v % 10000u} << 32);
+  auto const hundreds_high = ((merged * 10486u) >> 20) & ((uint64_t{0x7F} << 32) | 0x7Fu);
+  auto const hundreds = ((merged - (100u * hundreds_high)) << 16) + hundreds_high;
+  
+  auto tens = ((hundreds * 103u) >> 10) & ((uint64_t{0xF} << 48) | (uint64_t{0xF} << 32) | (uint64_t{0xF} << 16) | 0xFu);
+  tens += (hundreds - (10u * tens)) << 8;
+  tens += 0x3030303030303030u;
+  
+  for (auto i = 0; i != 8; ++i)
+    p[i] = static_cast<char>(tens >> (8 * i));
+}
+
+/** Formats an integer the way \c num_put does in the "C" locale.
+ * 
+ * The number is written backwards, ending at \a last . The buffer
+ * must have room for at least <tt>max_integer_chars<T>::value</tt>
+ * characters.
+ * 
+ * Just like the stream inserters, non-decimal output of a negative
+ * value shows the bit pattern of the value as an unsigned number,
+ * and the sign is only shown for signed types.
+ * 
+ * \param  last   The end of the buffer to write to.
+ * \param  v      The value to format.
+ * \param  flags  The stream formatting flags.
+ * 
+ * \return   A pointer to the first character of the formatted value.
+ */
+template <typename T>
+auto format_integer(char* last, T v, ios_base::fmtflags flags) -> char*
+{
+  using unsigned_type = typename make_unsigned<T>::type;
+  
+  auto const basefield = flags & ios_base::basefield;
+  auto const uppercase = bool(flags & ios_base::uppercase);
+  auto const showbase  = bool(flags & ios_base::showbase) && (v != T{0});
+  
+  auto p = last;
+  
+  if (basefield == ios_base::oct)
+  {
+    auto u = static_cast<unsigned_type>(v);
+    do
+    {
+      *--p = static_cast<char>('0' + (u & 7u));
+      u >>= 3;
+    } while (u);
+    
+    if (showbase)
+      *--p = '0';
+  }
+  else if (basefield == ios_base::hex)
+  {
+    auto const digits = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+    
+    auto u = static_cast<unsigned_type>(v);
+    do
+    {
+      *--p = digits[u & 15u];
+      u >>= 4;
+    } while (u);
+    
+    if (showbase)
+    {
+      *--p = uppercase ? 'X' : 'x';
+      *--p = '0';
+    }
+  }
+  else
+  {
+    static char const pairs[] =
+      "00010203040506070809" "10111213141516171819"
+      "20212223242526272829" "30313233343536373839"
+      "40414243444546474849" "50515253545556575859"
+      "60616263646566676869" "70717273747576777879"
+      "80818283848586878889" "90919293949596979899";
+    
+    auto const negative = is_signed<T>::value && (v < T{0});
+    auto u = negative ? unsigned_type(unsigned_type{0} - static_cast<unsigned_type>(v)) : static_cast<unsigned_type>(v);
+    
+    while (u >= 100000000u)
+    {
+      p -= 8;
+      encode_eight_digits(p, static_cast<uint32_t>(u % 100000000u));
+      u /= 100000000u;
+    }
+    
+    while (u >= 100u)
+    {
+      auto const i = static_cast<size_t>(u % 100u) * 2u;
+      u /= 100u;
+      *--p = pairs[i + 1];
+      *--p = pairs[i];
+    }
+    
+    if (u >= 10u)
+    {
+      auto const i = static_cast<size_t>(u) * 2u;
+      *--p = pairs[i + 1];
+      *--p = pairs[i];
+    }
+    else
+    {
+      *--p = static_cast<char>('0' + u);
+    }
+    
+    if (negative)
+      *--p = '-';
+    else if (is_signed<T>::value && (flags & ios_base::showpos))
+      *--p = '+';
+  }
+  
+  return p;
+}
+
+/** The maximum number of characters format_integer() can produce for
+ * values of an integer type: one octal digit for every three bits,
+ * rounded up, plus a base prefix or sign.
+ * 
+ * This is sized for the actual type, rather than the widest standard
+ * one, since extended integer types - such as \c __int128 in GNU
+ * mode - are integral types too.
+ * 
+ * \tparam T  The integer type.
+ */
+template <typename T>
+struct max_integer_chars :
+  integral_constant<size_t, numeric_limits<typename make_unsigned<T>::type>::digits / 3 + 3>
+{};
+
+/** Computes the length of an integer formatted by format_integer().
+ * 
+ * The digits are counted without formatting them.
+ * 
+ * \param  v      The value.
+ * \param  flags  The format flags.
+ * 
+ * \return   The number of characters format_integer() produces.
+ */
+template <typename T>
+auto integer_length(T v, ios_base::fmtflags flags) -> streamsize
+{
+  using unsigned_type = typename make_unsigned<T>::type;
+  
+  auto const basefield = flags & ios_base::basefield;
+  auto const showbase  = bool(flags & ios_base::showbase) && (v != T{0});
+  
+  if ((basefield == ios_base::oct) || (basefield == ios_base::hex))
+  {
+    auto const shift = (basefield == ios_base::oct) ? 3u : 4u;
+    auto u = static_cast<unsigned_type>(v);
+    auto n = streamsize{1};
+    
+    while (u >>= shift)
+      ++n;
+    
+    return n + (showbase ? ((basefield == ios_base::oct) ? 1 : 2) : 0);
+  }
+  
+  auto const negative = is_signed<T>::value && (v < T{0});
+  auto u = negative ? unsigned_type(unsigned_type{0} - static_cast<unsigned_type>(v)) : static_cast<unsigned_type>(v);
+  auto n = streamsize{1};
+  
+  for (; u >= 10000u; u /= 10000u)
+    n += 4;
+  
+  n += (u >= 10u) + (u >= 100u) + (u >= 1000u);
+  
+  return n + ((negative || (is_signed<T>::value && (flags & ios_base::showpos))) ? 1 : 0);
+}
+
+/** Direct writer for range elements.
+ * 
+ * Specializations of this template know how to write a value of
+ * type \c T straight to an output sink, producing exactly what the
+ * standard inserter would, but without the overhead of the sentry,
+ * the locale facet lookup and the virtual \c num_put call. The
+ * primary template is for types that can't be written directly.
+ * 
+ * Specializations have two static member functions:
+ *   - <tt>usable(s)</tt> returns \c true if the formatting state of
+ *     the stream \a s can be reproduced.
+ *   - <tt>write(sink, v, f)</tt> writes \a v to \a sink using the
+ *     formatting state \a f , and returns \c true on success.
+ * 
+ * \tparam T      The type of the values to write.
+ * \tparam CharT  The character type of the stream.
+ */
+template <typename T, typename CharT, typename = void>
+struct direct_writer :
+  false_type
+{
+  template <typename Traits>
+  static auto usable(basic_ios<CharT, Traits> const&) -> bool
+  {
+    return false;
+  }
+};
+
+/** Direct writer for characters.
+ * 
+ * Handles the stream's own character type, and - for narrow
+ * streams - \c signed \c char and \c unsigned \c char , which are
+ * written as plain \c char . Characters are padded like strings.
+ * 
+ * \tparam T      The character type.
+ * \tparam CharT  The character type of the stream.
+ */
+template <typename T, typename CharT>
+struct direct_writer<T, CharT, typename enable_if<is_same<T, CharT>::value ||
+    (is_same<CharT, char>::value && (is_same<T, signed char>::value || is_same<T, unsigned char>::value))>::type> :
+  true_type
+{
+  template <typename Traits>
+  static auto usable(basic_ios<CharT, Traits> const&) -> bool
+  {
+    return true;
+  }
+  
+  template <typename Sink>
+  static auto write(Sink& sink, T v, output_format<CharT> const& f) -> bool
+  {
+    auto const c = static_cast<CharT>(v);
+    
+    return put_padded(sink, &c, 1, 0, f);
+  }
+};
+
+/** Direct writer for strings.
+ * 
+ * \tparam CharT       The character type of the stream.
+ * \tparam Traits      The character traits of the string.
+ * \tparam Allocator   The allocator of the string.
+ */
+template <typename CharT, typename Traits, typename Allocator>
+struct direct_writer<basic_string<CharT, Traits, Allocator>, CharT> :
+  true_type
+{
+  template <typename StreamTraits>
+  static auto usable(basic_ios<CharT, StreamTraits> const&) -> bool
+  {
+    return is_same<Traits, StreamTraits>::value;
+  }
+  
+  template <typename Sink>
+  static auto write(Sink& sink, basic_string<CharT, Traits, Allocator> const& s, output_format<CharT> const& f) -> bool
+  {
+    return put_padded(sink, s.data(), static_cast<streamsize>(s.size()), 0, f);
+  }
+};
+
+/** Direct writer for null-terminated strings.
+ * 
+ * Just like the inserter, a null pointer is an error.
+ * 
+ * \tparam T      The pointer type.
+ * \tparam CharT  The character type of the stream.
+ */
+template <typename T, typename CharT>
+struct direct_writer<T, CharT, typename enable_if<is_same<T, CharT*>::value || is_same<T, CharT const*>::value>::type> :
+  true_type
+{
+  template <typename Traits>
+  static auto usable(basic_ios<CharT, Traits> const&) -> bool
+  {
+    return true;
+  }
+  
+  template <typename Sink>
+  static auto write(Sink& sink, CharT const* s, output_format<CharT> const& f) -> bool
+  {
+    if (!s)
+      return false;
+    
+    return put_padded(sink, s, static_cast<streamsize>(Sink::traits_type::length(s)), 0, f);
+  }
+};
+
+/** Direct writer for integer types.
+ * 
+ * Besides writing, this can compute the length of a formatted value
+ * without formatting it.
+ * 
+ * \tparam T      The integer type.
+ * \tparam CharT  The character type of the stream.
+ */
+template <typename T, typename CharT>
+struct direct_writer<T, CharT, typename enable_if<is_integral<T>::value && !is_character<T>::value && !is_same<T, bool>::value>::type> :
+  true_type
+{
+  template <typename Traits>
+  static auto usable(basic_ios<CharT, Traits> const& s) -> bool
+  {
+    return is_classic_numeric_format(s);
+  }
+  
+  template <typename Sink>
+  static auto write(Sink& sink, T v, output_format<CharT> const& f) -> bool
+  {
+    char buffer[max_integer_chars<T>::value];
+    auto const last = buffer + max_integer_chars<T>::value;
+    
+    return put_number(sink, static_cast<char const*>(format_integer(last, v, f.flags)), last, f);
+  }
+  
+  static auto length(T v, output_format<CharT> const& f) -> streamsize
+  {
+    auto const n = integer_length(v, f.flags);
+    return (f.width > n) ? f.width : n;
+  }
+};
+
+#ifdef STD_RANGEIO_HAVE_TO_CHARS
+/** Direct writer for floating point types.
+ * 
+ * Formatting is done with \c to_chars() , which is specified to
+ * give the same result as \c printf() in the "C" locale - just like
+ * \c num_put . Hexadecimal output and \c showpoint have no
+ * \c to_chars() equivalent, so they are not handled directly.
+ * 
+ * In shortest mode, the precision is ignored, and values are
+ * written with the fewest digits that read back to the same value
+ * (in the stream's fixed or scientific notation, if set). Floats
+ * are written as floats in that mode, not as doubles.
+ * 
+ * \tparam T      The floating point type.
+ * \tparam CharT  The character type of the stream.
+ */
+template <typename T, typename CharT>
+struct direct_writer<T, CharT, typename enable_if<is_floating_point<T>::value>::type> :
+  true_type
+{
+  template <typename Traits>
+  static auto usable(basic_ios<CharT, Traits> const& s) -> bool
+  {
+    auto const floatfield = s.flags() & ios_base::floatfield;
+    
+    return is_classic_numeric_format(s) &&
+      (floatfield != (ios_base::fixed | ios_base::scientific)) &&
+      !(s.flags() & ios_base::showpoint);
+  }
+  
+  static auto convert(char* first, char* last, T v, bool shortest, chars_format format, int precision) -> to_chars_result
+  {
+    // Just like the inserter, float is written as a double - unless
+    // it is written in the shortest form, which must be the shortest
+    // form of the float.
+    using value_type = typename conditional<is_same<T, float>::value, double, T>::type;
+    
+    if (!shortest)
+      return to_chars(first, last, static_cast<value_type>(v), format, precision);
+    
+    if (format == chars_format::general)
+      return to_chars(first, last, v);
+    
+    return to_chars(first, last, v, format);
+  }
+  
+  template <typename Sink>
+  static auto write(Sink& sink, T v, output_format<CharT> const& f) -> bool
+  {
+    auto const floatfield = f.flags & ios_base::floatfield;
+    auto const format =
+      (floatfield == ios_base::fixed) ? chars_format::fixed :
+      (floatfield == ios_base::scientific) ? chars_format::scientific :
+      chars_format::general;
+    auto const precision = (f.precision < 0) ? 6 : static_cast<int>(f.precision);
+    
+    char buffer[128];
+    auto heap = unique_ptr<char[]>{};
+    auto first = buffer + 1;
+    auto last = buffer + sizeof(buffer);
+    
+    auto result = convert(first, last, v, f.shortest, format, precision);
+    if (result.ec != errc{})
+    {
+      // Only huge precisions or fixed format with large or small
+      // exponents can overflow the local buffer.
+      auto const size = size_t(numeric_limits<T>::max_exponent10) + size_t(-numeric_limits<T>::min_exponent10) +
+        size_t(numeric_limits<T>::max_digits10) + size_t(precision) + 16u;
+      heap.reset(new char[size]);
+      first = heap.get() + 1;
+      last = heap.get() + size;
+      result = convert(first, last, v, f.shortest, format, precision);
+    }
+    
+    last = result.ptr;
+    
+    if ((f.flags & ios_base::showpos) && (*first != '-'))
+      *--first = '+';
+    
+    if (f.flags & ios_base::uppercase)
+    {
+      for (auto p = first; p != last; ++p)
+      {
+        if (*p >= 'a' && *p <= 'z')
+          *p = static_cast<char>(*p - 'a' + 'A');
+      }
+    }
+    
+    return put_number(sink, static_cast<char const*>(first), static_cast<char const*>(last), f);
+  }
+};
+#endif  // STD_RANGEIO_HAVE_TO_CHARS
+
+/** Helper template to detect the types written with \c num_put .
+ * 
+ * These are the arithmetic types other than the character types,
+ * which the standard inserters write with the stream's \c num_put
+ * facet.
+ * 
+ * \tparam T  The type to check.
+ */
+template <typename T>
+struct is_num_put_writable :
+  integral_constant<bool, is_arithmetic<T>::value && !is_character<T>::value>
+{};
+
+/** Converts a value to the type the standard inserter passes to
+ * \c num_put .
+ * 
+ * Just like the inserters, \c short and \c int are converted to
+ * their unsigned counterparts for octal and hexadecimal output, the
+ * other small integer types are widened to \c long or
+ * <tt>unsigned long</tt> , and \c float is widened to \c double .
+ * 
+ * \param  v      The value to convert.
+ * \param  flags  The stream's format flags.
+ * 
+ * \return   The converted value.
+ */
+inline auto num_put_value(short v, ios_base::fmtflags flags) -> long
+{
+  auto const basefield = flags & ios_base::basefield;
+  return ((basefield == ios_base::oct) || (basefield == ios_base::hex)) ? long(static_cast<unsigned short>(v)) : long(v);
+}
+
+inline auto num_put_value(int v, ios_base::fmtflags flags) -> long
+{
+  auto const basefield = flags & ios_base::basefield;
+  return ((basefield == ios_base::oct) || (basefield == ios_base::hex)) ? long(static_cast<unsigned int>(v)) : long(v);
+}
+
+inline auto num_put_value(unsigned short v, ios_base::fmtflags) -> unsigned long
+{
+  return v;
+}
+
+inline auto num_put_value(unsigned int v, ios_base::fmtflags) -> unsigned long
+{
+  return v;
+}
+
+inline auto num_put_value(float v, ios_base::fmtflags) -> double
+{
+  return v;
+}
+
+template <typename T>
+auto num_put_value(T v, ios_base::fmtflags) ->
+  typename enable_if<is_same<T, bool>::value || is_same<T, long>::value || is_same<T, unsigned long>::value ||
+    is_same<T, long long>::value || is_same<T, unsigned long long>::value ||
+    is_same<T, double>::value || is_same<T, long double>::value, T>::type
+{
+  return v;
+}
+
+/** Gets the precision with which a floating point value written in
+ * fixed notation reads back to the same value.
+ * 
+ * In fixed notation, the precision is the number of digits after the
+ * decimal point, so \c max_digits10 is only enough for values of at
+ * least 0.1; smaller values need one more digit for every power of
+ * ten they are below that. The power of ten is bounded from below
+ * by the binary exponent, so the result may be one digit more than
+ * needed, but never less.
+ * 
+ * \param  v          The value.
+ * \param  precision  The precision the value would be written with
+ *                    otherwise.
+ * 
+ * \return   The larger of \a precision and the precision needed.
+ */
+template <typename T>
+auto fixed_round_trip_precision(T v, streamsize precision, true_type) -> streamsize
+{
+  if (!isfinite(v) || (v == 0))
+    return precision;
+  
+  auto exponent = 0;
+  frexp(v, &exponent);
+  
+  auto const exponent10 = static_cast<streamsize>(floor((exponent - 1) * 0.30102999566398120));
+  auto const needed = streamsize{numeric_limits<T>::max_digits10} - 1 - exponent10;
+  
+  return (needed > precision) ? needed : precision;
+}
+
+template <typename T>
+auto fixed_round_trip_precision(T, streamsize precision, false_type) -> streamsize
+{
+  return precision;
+}
+
+/** Writer for values written with the stream's \c num_put facet.
+ * 
+ * This is for arithmetic values whose formatting can't be
+ * reproduced directly - because of the stream's locale, for
+ * example. The facet is looked up once, when the writer is
+ * constructed, and then called directly for every value, which is
+ * exactly what the inserter does, minus the sentry.
+ * 
+ * \tparam T       The type of the values to write.
+ * \tparam CharT   The character type of the stream.
+ * \tparam Traits  The character traits of the stream.
+ */
+template <typename T, typename CharT, typename Traits>
+struct num_put_writer
+{
+  using facet_type = num_put<CharT, ostreambuf_iterator<CharT, Traits>>;
+  
+  explicit num_put_writer(basic_ostream<CharT, Traits>& out) :
+    out_{out},
+    facet_{use_facet<facet_type>(out.getloc())}
+  {}
+  
+  auto write(streambuf_sink<CharT, Traits>& sink, T v, output_format<CharT> const& f) const -> bool
+  {
+    // The facet resets the width after every value.
+    out_.width(f.width);
+    
+    // In the shortest form, small values in fixed notation need more
+    // digits than the precision set for the whole range.
+    if (f.shortest && ((f.flags & ios_base::floatfield) == ios_base::fixed))
+      out_.precision(fixed_round_trip_precision(v, f.precision, is_floating_point<T>{}));
+    
+    return !facet_.put(ostreambuf_iterator<CharT, Traits>{&sink.buf_}, out_, f.fill, num_put_value(v, f.flags)).failed();
+  }
+  
+  basic_ostream<CharT, Traits>& out_;
+  facet_type const& facet_;
+};
+
+/** Handles an exception thrown while writing directly to a stream.
+ * 
+ * Does what the standard formatted output functions do: sets
+ * \c badbit on the stream, and rethrows the exception if the stream's
+ * exception mask includes \c badbit . Must be called from within a
+ * \c catch block.
+ * 
+ * \param  out  The stream being written to.
+ */
+template <typename CharT, typename Traits>
+auto handle_output_exception(basic_ostream<CharT, Traits>& out) -> void
+{
+  try
+  {
+    out.setstate(ios_base::badbit);
+  }
+  catch (ios_base::failure const&)
+  {}
+  
+  if (out.exceptions() & ios_base::badbit)
+    throw;
+}
+
+/** Handles an exception thrown earlier while writing directly to a
+ * stream.
+ * 
+ * Does the same as the other overload, for an exception that was
+ * caught and kept so that some clean up could be done first.
+ * 
+ * \param  out  The stream being written to.
+ * \param  e    The exception.
+ */
+template <typename CharT, typename Traits>
+auto handle_output_exception(basic_ostream<CharT, Traits>& out, exception_ptr e) -> void
+{
+  try
+  {
+    out.setstate(ios_base::badbit);
+  }
+  catch (ios_base::failure const&)
+  {}
+  
+  if (out.exceptions() & ios_base::badbit)
+    rethrow_exception(e);
+}
+
+/** Delimiter for directly written sequences without delimiters.
+ */
+struct no_delimiter
+{
+  auto usable() const -> bool
+  {
+    return true;
+  }
+  
+  template <typename Sink>
+  auto write(Sink&) const -> bool
+  {
+    return true;
+  }
+};
+
+/** Pre-rendered delimiter.
+ * 
+ * Specializations of this template render a delimiter to the
+ * stream's character type once, when the output operation begins,
+ * so that writing it between elements is just a raw write to the
+ * stream buffer. The primary template is for delimiter types that
+ * can't be pre-rendered, and must be written with their inserter
+ * every time.
+ * 
+ * Specializations have two member functions:
+ *   - <tt>usable()</tt> returns \c true if the delimiter could be
+ *     rendered.
+ *   - <tt>write(sink)</tt> writes the rendered delimiter to \a sink ,
+ *     and returns \c true on success.
+ * 
+ * \tparam Delim   The delimiter type (decayed).
+ * \tparam CharT   The character type of the stream.
+ * \tparam Traits  The character traits of the stream.
+ */
+template <typename Delim, typename CharT, typename Traits, typename = void>
+struct rendered_delimiter :
+  false_type
+{
+  rendered_delimiter(basic_ios<CharT, Traits> const&, Delim const&)
+  {}
+  
+  auto usable() const -> bool
+  {
+    return false;
+  }
+  
+  template <typename Sink>
+  auto write(Sink&) const -> bool
+  {
+    return false;
+  }
+};
+
+/** Pre-rendered single character delimiter.
+ * 
+ * Just like the character inserters, a \c char delimiter is widened
+ * for wide streams.
+ * 
+ * \tparam Delim   The delimiter type.
+ * \tparam CharT   The character type of the stream.
+ * \tparam Traits  The character traits of the stream.
+ */
+template <typename Delim, typename CharT, typename Traits>
+struct rendered_delimiter<Delim, CharT, Traits, typename enable_if<is_same<Delim, CharT>::value || is_same<Delim, char>::value ||
+    (is_same<CharT, char>::value && (is_same<Delim, signed char>::value || is_same<Delim, unsigned char>::value))>::type> :
+  true_type
+{
+  rendered_delimiter(basic_ios<CharT, Traits> const& s, Delim d) :
+    c_{(is_same<Delim, CharT>::value || is_same<CharT, char>::value) ? static_cast<CharT>(d) : s.widen(static_cast<char>(d))}
+  {}
+  
+  auto usable() const -> bool
+  {
+    return true;
+  }
+  
+  template <typename Sink>
+  auto write(Sink& sink) const -> bool
+  {
+    return sink.put(c_);
+  }
+  
+  CharT c_;
+};
+
+/** Pre-rendered null-terminated string delimiter.
+ * 
+ * Just like the string inserters, a \c char string delimiter is
+ * widened for wide streams, and a null pointer is an error (in
+ * which case the delimiter is not usable).
+ * 
+ * \tparam Delim   The delimiter type.
+ * \tparam CharT   The character type of the stream.
+ * \tparam Traits  The character traits of the stream.
+ */
+template <typename Delim, typename CharT, typename Traits>
+struct rendered_delimiter<Delim, CharT, Traits, typename enable_if<
+    is_same<Delim, CharT const*>::value || is_same<Delim, CharT*>::value ||
+    is_same<Delim, char const*>::value || is_same<Delim, char*>::value>::type> :
+  true_type
+{
+  rendered_delimiter(basic_ios<CharT, Traits> const& s, Delim d) :
+    usable_{d != nullptr}
+  {
+    if (d)
+      render(s, d);
+  }
+  
+  auto usable() const -> bool
+  {
+    return usable_;
+  }
+  
+  template <typename Sink>
+  auto write(Sink& sink) const -> bool
+  {
+    return sink.put(s_.data(), static_cast<streamsize>(s_.size()));
+  }
+  
+  void render(basic_ios<CharT, Traits> const&, CharT const* d)
+  {
+    s_.assign(d, Traits::length(d));
+  }
+  
+  template <typename C>
+  void render(basic_ios<CharT, Traits> const& s, C const* d)
+  {
+    for (; *d; ++d)
+      s_.push_back(s.widen(*d));
+  }
+  
+  basic_string<CharT, Traits> s_;
+  bool usable_;
+};
+
+/** Pre-rendered string delimiter.
+ * 
+ * \tparam CharT       The character type of the stream.
+ * \tparam Traits      The character traits of the stream.
+ * \tparam Allocator   The allocator of the string.
+ */
+template <typename CharT, typename Traits, typename Allocator>
+struct rendered_delimiter<basic_string<CharT, Traits, Allocator>, CharT, Traits> :
+  true_type
+{
+  rendered_delimiter(basic_ios<CharT, Traits> const&, basic_string<CharT, Traits, Allocator> const& d) :
+    s_(d.data(), d.size())
+  {}
+  
+  auto usable() const -> bool
+  {
+    return true;
+  }
+  
+  template <typename Sink>
+  auto write(Sink& sink) const -> bool
+  {
+    return sink.put(s_.data(), static_cast<streamsize>(s_.size()));
+  }
+  
+  basic_string<CharT, Traits> s_;
+};
+
+/** Writes a sequence of values directly to a stream.
+ * 
+ * A single sentry is constructed for the whole sequence - so any
+ * tied stream is flushed only once - then every value is formatted
+ * with the stream's formatting state and written to the sink, with
+ * the delimiter written between values. If a value or a delimiter
+ * can't be written completely, \c badbit is set on the stream and
+ * output stops.
+ * 
+ * If the sink stages the output, values it accepted may not have
+ * made it to the stream buffer when output stops; they are not
+ * counted, and \a next is moved back to the first of them. That is
+ * done before any exception is rethrown, after the sink has been
+ * flushed, so nothing staged is lost.
+ * 
+ * \tparam Sink    The type of the sink to write to.
+ * 
+ * \param  out     The stream to write to.
+ * \param  next    The next value to write. On return, it references
+ *                 the first value that was not written.
+ * \param  last    One past the last value to write.
+ * \param  f       The formatting state.
+ * \param  delim   The delimiter.
+ * \param  writer  The writer for the values.
+ * \param  count   Set to the number of values written successfully.
+ *                 Like \a next , it is kept up to date as values are
+ *                 written, so it is right even if an exception is
+ *                 thrown.
+ */
+template <typename Sink, typename Iterator, typename Sentinel, typename CharT, typename Traits, typename Delim, typename Writer>
+auto write_direct(basic_ostream<CharT, Traits>& out, Iterator& next, Sentinel last, output_format<CharT> const& f, Delim const& delim, Writer const& writer,
+    size_t& count) ->
+  void
+{
+  count = 0;
+  
+  typename basic_ostream<CharT, Traits>::sentry const sentry{out};
+  if (!sentry)
+    return;
+  
+  auto const first = next;
+  auto sink = Sink{*out.rdbuf()};
+  auto error = exception_ptr{};
+  
+  while (next != last)
+  {
+    auto&& v = *next;
+    
+    try
+    {
+      if (!writer.write(sink, v, f) || !sink.end_element())
+      {
+        out.setstate(ios_base::badbit);
+        break;
+      }
+    }
+    catch (...)
+    {
+      error = current_exception();
+      break;
+    }
+    
+    ++next;
+    ++count;
+    
+    if (next != last)
+    {
+      try
+      {
+        if (!delim.write(sink))
+        {
+          out.setstate(ios_base::badbit);
+          break;
+        }
+      }
+      catch (...)
+      {
+        error = current_exception();
+        break;
+      }
+    }
+  }
+  
+  try
+  {
+    if (!sink.flush())
+      out.setstate(ios_base::badbit);
+  }
+  catch (...)
+  {
+    if (!error)
+      error = current_exception();
+  }
+  
+  if (sink.committed() != count)
+  {
+    count = sink.committed();
+    next = first;
+    advance(next, count);
+  }
+  
+  if (error)
+    handle_output_exception(out, error);
+}
+
+template <typename Iterator, typename Sentinel, typename CharT, typename Traits, typename Delim>
+auto write_direct(basic_ostream<CharT, Traits>& out, Iterator& next, Sentinel last, output_format<CharT> const& f, Delim const& delim, size_t& count) ->
+  void
+{
+  write_direct<direct_sink_of<Iterator, CharT, Traits>>(out, next, last, f, delim,
+    direct_writer<typename iterator_traits<Iterator>::value_type, CharT>{}, count);
+}
+
+/** Writes a contiguous sequence of values directly to a stream.
+ * 
+ * \param  out    The stream to write to.
+ * \param  first  The first value to write.
+ * \param  last   One past the last value to write.
+ * \param  f      The formatting state.
+ * \param  delim  The delimiter.
+ * \param  count  Set to the number of values written successfully,
+ *                even if an exception is thrown.
+ */
+template <typename T, typename CharT, typename Traits, typename Delim>
+auto write_contiguous(basic_ostream<CharT, Traits>& out, T const* first, T const* last, output_format<CharT> const& f, Delim const& delim, size_t& count) ->
+  void
+{
+  write_direct(out, first, last, f, delim, count);
+}
+
+/** Writes a contiguous sequence of characters directly to a stream.
+ * 
+ * Unless every character has to be padded, the whole sequence is
+ * written to the stream buffer with a single \c sputn() . If not
+ * all of it can be written, \c badbit is set on the stream, and the
+ * characters that were written are counted.
+ * 
+ * \param  out    The stream to write to.
+ * \param  first  The first character to write.
+ * \param  last   One past the last character to write.
+ * \param  f      The formatting state.
+ * \param  count  Set to the number of characters written
+ *                successfully, even if an exception is thrown.
+ */
+template <typename CharT, typename Traits>
+auto write_contiguous(basic_ostream<CharT, Traits>& out, CharT const* first, CharT const* last, output_format<CharT> const& f, no_delimiter const&, size_t& count) ->
+  void
+{
+  if (f.width > 1)
+    return write_direct(out, first, last, f, no_delimiter{}, count);
+  
+  count = 0;
+  
+  typename basic_ostream<CharT, Traits>::sentry const sentry{out};
+  if (sentry)
+  {
+    try
+    {
+      auto const written = out.rdbuf()->sputn(first, last - first);
+      count = static_cast<size_t>(written);
+      
+      if (written != (last - first))
+        out.setstate(ios_base::badbit);
+    }
+    catch (...)
+    {
+      handle_output_exception(out);
+    }
+  }
+}
+
+} // namespace rangeio_detail
+} // namespace std
+
+#endif  // STD_RANGEIO_direct_output_
@@ -0,0 +1,257 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef STD_RANGEIO_discard_
+#define STD_RANGEIO_discard_
+
+#include <ios>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "input.hpp"
+
+namespace std {
+
+/** Trait for types whose text form is whitespace delimited.
+ * 
+ * For these types, a value in a stream is taken to be everything up
+ * to the next whitespace, so <tt>discard()</tt> can skip values
+ * without reading them. That holds for strings; specialize this for
+ * any other types it holds for.
+ * 
+ * Numbers are not whitespace delimited by default, because they
+ * aren't when the input is malformed: "1,2" or "12ab" is one token,
+ * but reading it as numbers fails after the first. Skipping them
+ * anyway would count values that can't be read, so only opt numbers
+ * in if the input is known to be well-formed.
+ * 
+ * \tparam T  The type.
+ */
+template <typename T>
+struct is_whitespace_delimited :
+  false_type
+{};
+
+template <typename CharT, typename Traits, typename Allocator>
+struct is_whitespace_delimited<basic_string<CharT, Traits, Allocator>> :
+  true_type
+{};
+
+namespace rangeio_detail {
+
+/** Empty range that discarded values are "read into".
+ * 
+ * Range input operations refer to a range, so discarding operations
+ * refer to the single instance of this.
+ * 
+ * \tparam T   The type of the values discarded.
+ */
+template <typename T>
+struct discard_range
+{
+  auto begin() const -> T*
+  {
+    return nullptr;
+  }
+  
+  auto end() const -> T*
+  {
+    return nullptr;
+  }
+  
+  static discard_range instance;
+};
+
+template <typename T>
+discard_range<T> discard_range<T>::instance{};
+
+/** Discarding range input behaviour type.
+ * 
+ * \tparam T   The type of the values discarded.
+ */
+template <typename T>
+struct discard_behaviour
+{
+  //! The type of the values read from the stream.
+  using value_type = T;
+  
+  /** Constructs a discard behaviour object.
+   * 
+   * \param   n   The number of values to discard in a single read
+   *              operation.
+   */
+  explicit discard_behaviour(size_t n) :
+    v_{},
+    n_{n}
+  {}
+  
+  /** Prepares the input operation.
+   * 
+   * \param  r   Unused.
+   * \param  i   Unused.
+   * 
+   * \return   A tuple containing:
+   *             - \c true if there are any values to discard,
+   *               \c false otherwise.
+   *             - \c nullptr .
+   */
+  auto prepare(discard_range<T>&, T*) ->
+    tuple<bool, T*>
+  {
+    current_ = 0;
+    
+    return make_tuple(n_ != 0, static_cast<T*>(nullptr));
+  }
+  
+  /** Reads a single value from the stream and discards it.
+   * 
+   * \param  in      The stream being read.
+   * \param  r       Unused.
+   * \param  i       Unused.
+   * \param  source  The input source to read the value with.
+   * 
+   * \tparam CharT   The character type of the stream being read.
+   * \tparam Traits  The character traits of the stream being read.
+   * 
+   * \return   A tuple containing:
+   *             - \c true if input succeeded and more values can be
+   *               discarded, \c false otherwise.
+   *             - \c nullptr .
+   *             - \c true if input succeeded, \c false otherwise.
+   *             - \c false .
+   */
+  template <typename CharT, typename Traits>
+  auto read(basic_istream<CharT, Traits>& in, discard_range<T>& r, T* i, input_source<CharT, Traits>& source) ->
+    tuple<bool, T*, bool, bool>
+  {
+    auto const result = read_bulk(in, r, i, source, 1);
+    
+    return make_tuple(get<0>(result), get<1>(result), get<2>(result) != 0, false);
+  }
+  
+  /** Reads several values from the stream and discards them.
+   * 
+   * Values of whitespace delimited types are skipped without being
+   * read at all.
+   * 
+   * \param  in      Unused.
+   * \param  r       Unused.
+   * \param  i       Unused.
+   * \param  source  The input source to read the values with.
+   * \param  max     The maximum number of values to discard.
+   * 
+   * \tparam CharT   The character type of the stream being read.
+   * \tparam Traits  The character traits of the stream being read.
+   * 
+   * \return   A tuple containing:
+   *             - \c true if \a max values were discarded, and more
+   *               can be, \c false otherwise.
+   *             - \c nullptr .
+   *             - the number of values discarded.
+   *             - zero.
+   */
+  template <typename CharT, typename Traits>
+  auto read_bulk(basic_istream<CharT, Traits>&, discard_range<T>&, T* i, input_source<CharT, Traits>& source, size_t max) ->
+    tuple<bool, T*, size_t, size_t>
+  {
+    auto n = size_t{0};
+    
+    try
+    {
+      while ((n != max) && (current_ < n_) && discard_one(source, is_whitespace_delimited<T>{}))
+      {
+        ++current_;
+        ++n;
+      }
+    }
+    catch (...)
+    {
+      progress_ = make_tuple(i, n, size_t{0});
+      throw;
+    }
+    
+    return make_tuple((n == max) && (current_ < n_), i, n, size_t{0});
+  }
+  
+  /** Gets how far the last call to read_bulk() got before it threw.
+   * 
+   * \return   A tuple containing:
+   *             - the value that \c next should be set to.
+   *             - the number of values discarded.
+   *             - zero.
+   */
+  auto progress_after_exception() ->
+    tuple<T*, size_t, size_t>
+  {
+    return progress_;
+  }
+  
+  template <typename CharT, typename Traits>
+  auto discard_one(input_source<CharT, Traits>& source, true_type) -> bool
+  {
+    return source.template skip<T>();
+  }
+  
+  template <typename CharT, typename Traits>
+  auto discard_one(input_source<CharT, Traits>& source, false_type) -> bool
+  {
+    return source.extract(v_);
+  }
+  
+  //! An instance of the value type, to use as a buffer for reading into.
+  T v_;
+  
+  //! The number of values to discard in a single read operation.
+  size_t const n_ = numeric_limits<size_t>::max();
+  
+  //! The number of values discarded so far in the current read operation.
+  size_t current_ = 0;
+  
+  //! How far the last call to read_bulk() got, if it threw.
+  tuple<T*, size_t, size_t> progress_;
+};
+
+} // namespace rangeio_detail
+
+/** Discarding range input function.
+ * 
+ * Reads up to \a n values of type \a T , and throws them away. The
+ * \c count of the returned object is the number of values
+ * discarded; nothing is ever \c stored .
+ * 
+ * If \a T is whitespace delimited (see \c is_whitespace_delimited ),
+ * values are skipped without being read: the stream is just scanned
+ * for the whitespace after them.
+ * 
+ * \param   n   The maximum number of values to discard in a single
+ *              input operation.
+ * 
+ * \tparam  T   The type of the values to discard.
+ * 
+ * \return  A range input operation object with the desired behaviour.
+ */
+template <typename T>
+auto discard(size_t n = numeric_limits<size_t>::max()) ->
+  rangeio_detail::range_input_operation<rangeio_detail::discard_range<T>, T*, rangeio_detail::discard_behaviour<T>>
+{
+  return input(rangeio_detail::discard_range<T>::instance, static_cast<T*>(nullptr), rangeio_detail::discard_behaviour<T>{n});
+}
+
+} // namespace std
+
+#endif // STD_RANGEIO_discard_
@@ -28,6 +28,9 @@ namespace rangeio_detail {
 template <typename Range>
 struct front_insert_behaviour
 {
+  //! The type of the values read from the stream.
+  using value_type = value_type_of<Range>;
+  
   /** Constructs a front insert behaviour object.
    * 
    * \param   n   The number of elements to read in a single read operation.
@@ -61,9 +64,10 @@ struct front_insert_behaviour
    * Attempts to read a value from \a in and - if successful - uses
    * <tt>r.push_front()</tt> to move the value into the range.
    * 
-   * \param  in  The stream being read.
-   * \param  r   The range being read into.
-   * \param  i   Unused.
+   * \param  in      The stream being read.
+   * \param  r       The range being read into.
+   * \param  i       Unused.
+   * \param  source  The input source to read the value with.
    * 
    * \tparam CharT   The character type of the stream being read.
    * \tparam Traits  The character traits of the stream being read.
@@ -75,10 +79,10 @@ struct front_insert_behaviour
    *             - \c true if input succeeded, \c false otherwise.
    */
   template <typename CharT, typename Traits>
-  auto read(basic_istream<CharT, Traits>& in, Range& r, iterator_type_of<Range> i) ->
+  auto read(basic_istream<CharT, Traits>&, Range& r, iterator_type_of<Range> i, input_source<CharT, Traits>& source) ->
     tuple<bool, iterator_type_of<Range>, bool, bool>
   {
-    if ((current_ < n_) && (in >> v_))
+    if ((current_ < n_) && source.extract(v_))
     {
       r.push_front(move(v_));
       return make_tuple(++current_ < n_, begin(r), true, true);
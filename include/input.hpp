@@ -16,31 +16,22 @@
 #ifndef STD_RANGEIO_input_
 #define STD_RANGEIO_input_
 
+#include <ios>
 #include <iosfwd>
 #include <iterator>
 #include <limits>
 #include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "direct-input.hpp"
+#include "range-traits.hpp"
 #include "stream-formatting-saver.hpp"
 
 namespace std {
 namespace rangeio_detail {
 
-/** Helper template to deduce the iterator type of a range.
- * 
- * \tparam Range  The range to deduce the iterator type of.
- */
-template <typename Range>
-using iterator_type_of = decltype(begin(declval<Range&>()));
-
-/** Helper template to deduce the value type of a range.
- * 
- * \tparam Range  The range to deduce the value type of.
- */
-template <typename Range>
-using value_type_of = typename iterator_traits<iterator_type_of<Range>>::value_type;
-
 #ifdef DOXYGEN_RUNNING
 /** The interface required for the input behaviour type.
  * 
@@ -55,6 +46,16 @@ using value_type_of = typename iterator_traits<iterator_type_of<Range>>::value_t
 template <typename Range, typename Iterator>
 struct basic_input_behaviour
 {
+  /** The type of the values read from the stream.
+   * 
+   * This member is optional. If it is present, and the standard
+   * extractor for the type never changes the stream formatting
+   * state (other than the width), only the width is restored
+   * between reads. Otherwise, the full formatting state is
+   * restored before every read.
+   */
+  using value_type = value_type_of<Range>;
+  
   /** Prepares the input operation.
    * 
    * This function is called once at the beginning of every input
@@ -114,9 +115,228 @@ struct basic_input_behaviour
       Range& r,
       Iterator i) ->
     tuple<bool, Iterator, bool, bool>;
+  
+  /** Reads a single value from the stream and stores it in the range.
+   * 
+   * This overload is optional. If it is present, it is used instead
+   * of the one above, and gets the input source for the operation
+   * as well, which can read values faster than their extractors by
+   * using the locale facets looked up once for the whole operation.
+   * 
+   * \param  in      The stream being read.
+   * \param  r       The range being read into.
+   * \param  i       An iterator to the next location in the range
+   *                 to read into.
+   * \param  source  The input source to read values with.
+   * 
+   * \return   The same as the overload above.
+   */
+  template <typename CharT, typename Traits>
+  auto read(
+      basic_istream<CharT, Traits>& in,
+      Range& r,
+      Iterator i,
+      input_source<CharT, Traits>& source) ->
+    tuple<bool, Iterator, bool, bool>;
+  
+  /** Reads several values from the stream and stores them in the
+   * range.
+   * 
+   * This function is optional. If it is present, it is used instead
+   * of read(), and is called repeatedly during the input operation
+   * until it returns \c false or the stream fails. It should read up
+   * to \a max values - as many as it can, until input fails or the
+   * behaviour wants to stop - saving the per-value overhead of
+   * calling read() and unpacking its result.
+   * 
+   * The formatting state of the stream is restored by the input
+   * source before each value is read.
+   * 
+   * \param  in      The stream being read.
+   * \param  r       The range being read into.
+   * \param  i       An iterator to the next location in the range
+   *                 to read into.
+   * \param  source  The input source to read values with.
+   * \param  max     The maximum number of values to read.
+   * 
+   * \return   A tuple containing:
+   *             - \c true if input should continue,
+   *               \c false if it should be aborted.
+   *             - the value that \c next should be set to.
+   *             - the number of values successfully read.
+   *             - the number of values read that were stored in the
+   *               range.
+   */
+  template <typename CharT, typename Traits>
+  auto read_bulk(
+      basic_istream<CharT, Traits>& in,
+      Range& r,
+      Iterator i,
+      input_source<CharT, Traits>& source,
+      size_t max) ->
+    tuple<bool, Iterator, size_t, size_t>;
+  
+  /** Gets how far the last call to read_bulk() got before it threw.
+   * 
+   * This function is optional. If it is present, it is called when
+   * read_bulk() throws, before the exception is passed on, so that
+   * \c next , \c count and \c stored take account of the values
+   * already read by that call.
+   * 
+   * \return   A tuple containing:
+   *             - the value that \c next should be set to.
+   *             - the number of values successfully read.
+   *             - the number of values read that were stored in the
+   *               range.
+   */
+  auto progress_after_exception() ->
+    tuple<Iterator, size_t, size_t>;
 };
 #endif  // DOXYGEN_RUNNING
 
+//! The maximum number of values read_bulk() is asked for at a time.
+constexpr size_t read_bulk_size = 4096;
+
+/** Helper template to deduce the type of the values read by a behaviour.
+ * 
+ * This is the behaviour's \c value_type member type if it has one,
+ * or \c void otherwise.
+ * 
+ * \tparam Behaviour  The input behaviour type.
+ */
+template <typename Behaviour, typename = void>
+struct behaviour_value_type
+{
+  using type = void;
+};
+
+template <typename Behaviour>
+struct behaviour_value_type<Behaviour, typename conditional<true, void, typename Behaviour::value_type>::type>
+{
+  using type = typename Behaviour::value_type;
+};
+
+/** Helper template to detect behaviours that read with an input source.
+ * 
+ * \tparam Behaviour  The input behaviour type.
+ * \tparam Range      The range type being read into.
+ * \tparam Iterator   The iterator type.
+ * \tparam CharT      The character type of the stream.
+ * \tparam Traits     The character traits of the stream.
+ */
+template <typename Behaviour, typename Range, typename Iterator, typename CharT, typename Traits, typename = void>
+struct reads_from_source :
+  false_type
+{};
+
+template <typename Behaviour, typename Range, typename Iterator, typename CharT, typename Traits>
+struct reads_from_source<Behaviour, Range, Iterator, CharT, Traits, decltype(void(declval<Behaviour&>().read(
+    declval<basic_istream<CharT, Traits>&>(), declval<Range&>(), declval<Iterator>(), declval<input_source<CharT, Traits>&>())))> :
+  true_type
+{};
+
+/** Reads a single value using the behaviour's input source overload. */
+template <typename Behaviour, typename Range, typename Iterator, typename CharT, typename Traits>
+auto read_value(Behaviour& op, basic_istream<CharT, Traits>& in, Range& r, Iterator i, input_source<CharT, Traits>& source, true_type) ->
+  tuple<bool, Iterator, bool, bool>
+{
+  return op.read(in, r, i, source);
+}
+
+/** Reads a single value using the behaviour's plain overload. */
+template <typename Behaviour, typename Range, typename Iterator, typename CharT, typename Traits>
+auto read_value(Behaviour& op, basic_istream<CharT, Traits>& in, Range& r, Iterator i, input_source<CharT, Traits>&, false_type) ->
+  tuple<bool, Iterator, bool, bool>
+{
+  return op.read(in, r, i);
+}
+
+/** Helper template to detect behaviours that move the insert position
+ * when reading throws.
+ * 
+ * \tparam Behaviour  The input behaviour type.
+ * \tparam Iterator   The iterator type.
+ */
+template <typename Behaviour, typename Iterator, typename = void>
+struct has_next_after_exception :
+  false_type
+{};
+
+template <typename Behaviour, typename Iterator>
+struct has_next_after_exception<Behaviour, Iterator, decltype(void(declval<Behaviour&>().next_after_exception(declval<Iterator>())))> :
+  true_type
+{};
+
+/** Gets the next position from a behaviour whose read threw. */
+template <typename Behaviour, typename Iterator>
+auto next_after_exception(Behaviour& op, Iterator i, true_type) ->
+  Iterator
+{
+  return op.next_after_exception(i);
+}
+
+/** Keeps the next position for a behaviour that doesn't move it when
+ * reading throws.
+ */
+template <typename Behaviour, typename Iterator>
+auto next_after_exception(Behaviour&, Iterator i, false_type) ->
+  Iterator
+{
+  return i;
+}
+
+/** Helper template to detect behaviours that report their progress
+ * when reading several values at once throws.
+ * 
+ * \tparam Behaviour  The input behaviour type.
+ */
+template <typename Behaviour, typename = void>
+struct has_progress_after_exception :
+  false_type
+{};
+
+template <typename Behaviour>
+struct has_progress_after_exception<Behaviour, decltype(void(declval<Behaviour&>().progress_after_exception()))> :
+  true_type
+{};
+
+/** Gets the progress from a behaviour whose bulk read threw. */
+template <typename Behaviour, typename Iterator>
+auto progress_after_exception(Behaviour& op, Iterator, true_type) ->
+  tuple<Iterator, size_t, size_t>
+{
+  return op.progress_after_exception();
+}
+
+/** Reports no progress for a behaviour that can't say how far its
+ * bulk read got.
+ */
+template <typename Behaviour, typename Iterator>
+auto progress_after_exception(Behaviour&, Iterator i, false_type) ->
+  tuple<Iterator, size_t, size_t>
+{
+  return make_tuple(i, size_t{0}, size_t{0});
+}
+
+/** Helper template to detect behaviours that read several values at once.
+ * 
+ * \tparam Behaviour  The input behaviour type.
+ * \tparam Range      The range type being read into.
+ * \tparam Iterator   The iterator type.
+ * \tparam CharT      The character type of the stream.
+ * \tparam Traits     The character traits of the stream.
+ */
+template <typename Behaviour, typename Range, typename Iterator, typename CharT, typename Traits, typename = void>
+struct reads_in_bulk :
+  false_type
+{};
+
+template <typename Behaviour, typename Range, typename Iterator, typename CharT, typename Traits>
+struct reads_in_bulk<Behaviour, Range, Iterator, CharT, Traits, decltype(void(declval<Behaviour&>().read_bulk(
+    declval<basic_istream<CharT, Traits>&>(), declval<Range&>(), declval<Iterator>(), declval<input_source<CharT, Traits>&>(), size_t{})))> :
+  true_type
+{};
+
 /** Range input operation type.
  * 
  * This is the type returned by all the range input functions. It
@@ -159,10 +379,162 @@ struct range_input_operation
   //! The number of values written to the range during the last input operation.
   size_t stored = 0;
   
+  //! The number of malformed values skipped during the last input
+  //! operation, if recovering.
+  size_t skipped = 0;
+  
+  //! The stream positions at which the first malformed values skipped
+  //! during the last input operation were found, if recovering (-1
+  //! where the stream can't tell).
+  vector<streamoff> bad_positions;
+  
   //! Iterator references the next position that will be read into.
   Iterator next;
+  
+  //! Whether to skip malformed values and carry on reading.
+  bool recover_ = false;
+  
+  //! The maximum number of positions to record in \c bad_positions .
+  size_t max_bad_positions_ = 0;
 };
 
+/** Skips a malformed value, so input can carry on after it.
+ * 
+ * Only a plain failure is recovered from: if the stream has reached
+ * its end, or is bad, there is nothing more to read. The position
+ * recorded is where the value's token starts, if the input source
+ * read it, or where reading it failed otherwise.
+ * 
+ * \param   in      The stream being read.
+ * \param   p       The range input object.
+ * \param   source  The input source.
+ * 
+ * \return  \c true if the value was skipped, and input can carry on.
+ */
+template <typename Range, typename Iterator, typename Behaviour, typename CharT, typename Traits>
+auto skip_bad_value(basic_istream<CharT, Traits>& in, range_input_operation<Range, Iterator, Behaviour>& p,
+    input_source<CharT, Traits>& source) ->
+  bool
+{
+  if (!p.recover_ || (in.rdstate() != ios_base::failbit))
+    return false;
+  
+  in.clear();
+  
+  if (p.bad_positions.size() < p.max_bad_positions_)
+  {
+    auto position = source.token_start_;
+    
+    if (!source.marked_)
+    {
+      try
+      {
+        position = streamoff(in.rdbuf()->pubseekoff(0, ios_base::cur, ios_base::in));
+      }
+      catch (...)
+      {
+        handle_input_exception(in);
+      }
+    }
+    
+    p.bad_positions.push_back(position);
+    source.marking_ = p.bad_positions.size() < p.max_bad_positions_;
+  }
+  
+  ++p.skipped;
+  source.skip_malformed();
+  
+  return static_cast<bool>(in);
+}
+
+/** Reads the elements of a range one at a time.
+ * 
+ * Calls the behaviour's <tt>read()</tt> in a loop, until it says to
+ * stop or the stream fails. If <tt>read()</tt> throws, and the
+ * behaviour has a <tt>next_after_exception()</tt> member, \c next is
+ * updated from it before the exception is passed on.
+ * 
+ * \param   in          The stream to read from.
+ * \param   p           The range input object.
+ * \param   formatting  The saved formatting state of \a in .
+ * \param   source      The input source.
+ */
+template <typename Range, typename Iterator, typename Behaviour, typename CharT, typename Traits>
+auto read_elements(basic_istream<CharT, Traits>& in, range_input_operation<Range, Iterator, Behaviour>& p,
+    stream_formatting_saver<CharT, Traits> const& formatting, input_source<CharT, Traits>& source, false_type) ->
+  void
+{
+  auto continue_input = true;
+  
+  while (in && continue_input)
+  {
+    formatting.template restore_for<typename behaviour_value_type<Behaviour>::type>();
+    
+    auto value_read   = false;
+    auto value_stored = false;
+    
+    try
+    {
+      tie(continue_input, p.next, value_read, value_stored) =
+        read_value(p.op_, in, p.range_, p.next, source, reads_from_source<Behaviour, Range, Iterator, CharT, Traits>{});
+    }
+    catch (...)
+    {
+      p.next = next_after_exception(p.op_, p.next, has_next_after_exception<Behaviour, Iterator>{});
+      throw;
+    }
+    
+    if (value_read)
+      ++p.count;
+    
+    if (value_stored)
+      ++p.stored;
+  }
+}
+
+/** Reads the elements of a range several at a time.
+ * 
+ * Calls the behaviour's <tt>read_bulk()</tt> in a loop, until it
+ * says to stop or the stream fails. If <tt>read_bulk()</tt> throws,
+ * and the behaviour has a <tt>progress_after_exception()</tt> member,
+ * \c next , \c count and \c stored are updated from it before the
+ * exception is passed on.
+ * 
+ * \param   in          The stream to read from.
+ * \param   p           The range input object.
+ * \param   formatting  The saved formatting state of \a in .
+ * \param   source      The input source.
+ */
+template <typename Range, typename Iterator, typename Behaviour, typename CharT, typename Traits>
+auto read_elements(basic_istream<CharT, Traits>& in, range_input_operation<Range, Iterator, Behaviour>& p,
+    stream_formatting_saver<CharT, Traits> const&, input_source<CharT, Traits>& source, true_type) ->
+  void
+{
+  auto continue_input = true;
+  
+  while (in && continue_input)
+  {
+    auto values_read   = size_t{0};
+    auto values_stored = size_t{0};
+    
+    try
+    {
+      tie(continue_input, p.next, values_read, values_stored) = p.op_.read_bulk(in, p.range_, p.next, source, read_bulk_size);
+    }
+    catch (...)
+    {
+      tie(p.next, values_read, values_stored) = progress_after_exception(p.op_, p.next, has_progress_after_exception<Behaviour>{});
+      
+      p.count += values_read;
+      p.stored += values_stored;
+      throw;
+    }
+    
+    p.count += values_read;
+    p.stored += values_stored;
+  }
+}
+
 /** Extraction operator for range input.
  * 
  * This function handles pretty much all of the logic for range
@@ -170,10 +542,18 @@ struct range_input_operation
  * of the \c Behaviour object, setting the counts to zero and
  * calling <tt>prepare()</tt> before attempting any input. If the
  * input can continue, the function begins calling <tt>read()</tt>
- * in a loop until input is complete (as determined by the
+ * (or <tt>read_bulk()</tt>, if the behaviour has it) in a loop until input is complete (as determined by the
  * \c Behaviour object), handling incrementing \c count and
  * \c stored and the stream formatting.
  * 
+ * The stream tied to \a in is flushed once, before the first value
+ * is read, rather than by every value's sentry.
+ * 
+ * If the operation was made with <tt>recovering()</tt>, a value that
+ * fails to read doesn't end the input: the failure is cleared, the
+ * rest of the malformed token is skipped, counted in \c skipped , and
+ * reading carries on.
+ * 
  * \param   in  The stream to read from.
  * \param   p   The range input object.
  * 
@@ -191,30 +571,26 @@ auto operator>>(basic_istream<CharT, Traits>& in, range_input_operation<Range, I
 {
   p.count = 0;
   p.stored = 0;
+  p.skipped = 0;
+  p.bad_positions.clear();
   
   auto continue_input = false;
   tie(continue_input, p.next) = p.op_.prepare(p.range_, p.next);
   
   if (continue_input)
   {
+    tie_flusher<CharT, Traits> const flusher{in};
+    
     auto const formatting = stream_formatting_saver<CharT, Traits>{in};
+    auto source = input_source<CharT, Traits>{in, formatting};
+    source.recovering_ = p.recover_;
+    source.marking_ = p.recover_ && (p.max_bad_positions_ != 0);
     
-    while (in && continue_input)
+    do
     {
-      formatting.restore();
-      
-      auto value_read   = false;
-      auto value_stored = false;
-      
-      tie(continue_input, p.next, value_read, value_stored) =
-        p.op_.read(in, p.range_, p.next);
-      
-      if (value_read)
-        ++p.count;
-      
-      if (value_stored)
-        ++p.stored;
+      read_elements(in, p, formatting, source, reads_in_bulk<Behaviour, Range, Iterator, CharT, Traits>{});
     }
+    while (skip_bad_value(in, p, source));
   }
   
   in.width(0);
@@ -295,11 +671,52 @@ auto input(Range& r, Behaviour b) ->
   return {r, i, move(b)};
 }
 
+/** Recovering range input function.
+ * 
+ * Makes a range input operation carry on past malformed values,
+ * instead of stopping at the first one. Values are read a whitespace
+ * delimited token at a time: a token that doesn't read as a value,
+ * or that has anything but whitespace after the value read from it,
+ * is malformed. Each malformed token is skipped as a whole and
+ * counted in \c skipped , and the stream positions at which the
+ * first \a n of them start are kept in \c bad_positions . Finding
+ * those means asking the stream buffer for its position before each
+ * value, until \a n positions have been recorded, so pass zero if
+ * they aren't needed.
+ * 
+ * A malformed value at the very end of the stream can't be told
+ * apart from the end of the input, so it isn't counted. Nor can
+ * input recover if the stream's exception mask includes \c failbit .
+ * 
+ * \param   p   The range input operation.
+ * \param   n   The maximum number of positions to record.
+ * 
+ * \tparam  Range     The range type to read into.
+ * \tparam  Iterator  The type of the iterator.
+ * \tparam  Behaviour The input behaviour.
+ * 
+ * \return  The range input operation, recovering from malformed
+ *          values.
+ */
+template <typename Range, typename Iterator, typename Behaviour>
+auto recovering(rangeio_detail::range_input_operation<Range, Iterator, Behaviour>&& p, size_t n = 16) ->
+  rangeio_detail::range_input_operation<Range, Iterator, Behaviour>
+{
+  p.recover_ = true;
+  p.max_bad_positions_ = n;
+  
+  return move(p);
+}
+
 } // namespace std
 
 #include "overwrite.hpp"
 #include "back_insert.hpp"
 #include "front_insert.hpp"
 #include "insert.hpp"
+#include "discard.hpp"
+#include "read_lazy.hpp"
+#include "reduce.hpp"
+#include "read_binary.hpp"
 
 #endif // STD_RANGEIO_input_
@@ -16,6 +16,10 @@
 #ifndef STD_RANGEIO_insert_
 #define STD_RANGEIO_insert_
 
+#include <exception>
+#include <iterator>
+#include <vector>
+
 #include "input.hpp"
 
 namespace std {
@@ -28,6 +32,9 @@ namespace rangeio_detail {
 template <typename Range, typename Iterator>
 struct insert_behaviour
 {
+  //! The type of the values read from the stream.
+  using value_type = value_type_of<Range>;
+  
   /** Constructs an insert behaviour object.
    * 
    * \param   n   The number of elements to read in a single read operation.
@@ -60,9 +67,10 @@ struct insert_behaviour
    * <tt>r.insert()</tt> to move the value into the range at the position
    * referenced by \a i .
    * 
-   * \param  in  The stream being read.
-   * \param  r   The range being read into.
-   * \param  i   An iterator to the next location in the range to read into.
+   * \param  in      The stream being read.
+   * \param  r       The range being read into.
+   * \param  i       An iterator to the next location in the range to read into.
+   * \param  source  The input source to read the value with.
    * 
    * \tparam CharT   The character type of the stream being read.
    * \tparam Traits  The character traits of the stream being read.
@@ -75,10 +83,10 @@ struct insert_behaviour
    *             - \c true if input succeeded, \c false otherwise.
    */
   template <typename CharT, typename Traits>
-  auto read(basic_istream<CharT, Traits>& in, Range& r, Iterator i) ->
+  auto read(basic_istream<CharT, Traits>&, Range& r, Iterator i, input_source<CharT, Traits>& source) ->
     tuple<bool, Iterator, bool, bool>
   {
-    if ((current_ < n_) && (in >> v_))
+    if ((current_ < n_) && source.extract(v_))
       return make_tuple(++current_ < n_, ++Iterator(r.insert(i, move(v_))), true, true);
     
     return make_tuple(false, i, false, false);
@@ -95,6 +103,151 @@ struct insert_behaviour
   size_t current_ = 0;
 };
 
+/** Bulk inserting range input behaviour type.
+ * 
+ * Rather than inserting every value into the range as soon as it is
+ * read, the values are collected in a staging buffer, and inserted
+ * all at once with a single range <tt>insert()</tt> at the end of
+ * the input operation. For ranges like \c std::vector , that moves
+ * the elements after the insert position only once, instead of once
+ * per value.
+ * 
+ * \tparam Range     The range type being inserted into.
+ * \tparam Iterator  The iterator type.
+ */
+template <typename Range, typename Iterator>
+struct bulk_insert_behaviour
+{
+  //! The type of the values read from the stream.
+  using value_type = value_type_of<Range>;
+  
+  /** Constructs a bulk insert behaviour object.
+   * 
+   * \param   n   The number of elements to read in a single read operation.
+   */
+  bulk_insert_behaviour(size_t n = numeric_limits<size_t>::max()) :
+    v_{},
+    n_{n}
+  {}
+  
+  /** Prepares the input operation.
+   * 
+   * \param  r   The range being read into.
+   * \param  i   An iterator to the next location in the range to read into.
+   * 
+   * \return   A tuple containing:
+   *             - \c true .
+   *             - \a i .
+   */
+  auto prepare(Range&, Iterator i) ->
+    tuple<bool, Iterator>
+  {
+    staged_.clear();
+    return make_tuple(true, i);
+  }
+  
+  /** Reads a single value from the stream and stages it for insertion.
+   * 
+   * Attempts to read a value from \a in and - if successful - moves
+   * it into the staging buffer. When no more values are to be read -
+   * because input failed, or \c n values have been read - all the
+   * staged values are inserted into the range at the position
+   * referenced by \a i . That also happens if reading throws, before
+   * the exception is passed on: every value read successfully before
+   * the one that threw is committed to the range, and the position
+   * after them can be had from next_after_exception() .
+   * 
+   * \param  in      The stream being read.
+   * \param  r       The range being read into.
+   * \param  i       The position in the range to insert at.
+   * \param  source  The input source to read the value with.
+   * 
+   * \tparam CharT   The character type of the stream being read.
+   * \tparam Traits  The character traits of the stream being read.
+   * 
+   * \return   A tuple containing:
+   *             - \c true if input succeeded and more values are to
+   *               be read, \c false otherwise.
+   *             - \a i while values are being staged, or an iterator
+   *               to the position after the inserted values once they
+   *               have been inserted.
+   *             - \c true if input succeeded, \c false otherwise.
+   *             - \c true if input succeeded, \c false otherwise.
+   */
+  template <typename CharT, typename Traits>
+  auto read(basic_istream<CharT, Traits>&, Range& r, Iterator i, input_source<CharT, Traits>& source) ->
+    tuple<bool, Iterator, bool, bool>
+  {
+    auto value_read = false;
+    
+    try
+    {
+      value_read = (staged_.size() < n_) && source.extract(v_);
+    }
+    catch (...)
+    {
+      next_after_exception_ = insert_staged(r, i);
+      throw;
+    }
+    
+    if (value_read)
+    {
+      staged_.push_back(move(v_));
+      
+      if (staged_.size() < n_)
+        return make_tuple(true, i, true, true);
+    }
+    
+    return make_tuple(false, insert_staged(r, i), value_read, value_read);
+  }
+  
+  /** Gets the next position after <tt>read()</tt> has thrown.
+   * 
+   * The staged values are inserted before the exception is passed on,
+   * which may invalidate the iterator the read was given.
+   * 
+   * \return   An iterator to the position after the values inserted
+   *           when reading threw.
+   */
+  auto next_after_exception(Iterator) -> Iterator
+  {
+    return next_after_exception_;
+  }
+  
+  /** Inserts the staged values into the range.
+   * 
+   * \param  r   The range being read into.
+   * \param  i   The position in the range to insert at.
+   * 
+   * \return   An iterator to the position after the inserted values.
+   */
+  auto insert_staged(Range& r, Iterator i) -> Iterator
+  {
+    if (staged_.empty())
+      return i;
+    
+    auto const n = staged_.size();
+    auto const first = Iterator(r.insert(i, make_move_iterator(staged_.begin()), make_move_iterator(staged_.end())));
+    
+    staged_.clear();
+    
+    return std::next(first, static_cast<typename iterator_traits<Iterator>::difference_type>(n));
+  }
+  
+  //! An instance of the range's value type, to use as a buffer for reading
+  //! into.
+  value_type_of<Range> v_;
+  
+  //! The number of elements to read in a single read operation.
+  size_t const n_ = numeric_limits<size_t>::max();
+  
+  //! The values read so far in the current read operation.
+  vector<value_type_of<Range>> staged_;
+  
+  //! The position after the values inserted when reading last threw.
+  Iterator next_after_exception_{};
+};
+
 } // namespace rangeio_detail
 
 /** General insert range input function.
@@ -134,6 +287,49 @@ auto insert_n(Range& r, Iterator i, size_t n) ->
   return input(r, i, rangeio_detail::insert_behaviour<Range, Iterator>{n});
 }
 
+/** Bulk insert range input function.
+ * 
+ * Reads values just like insert(), but inserts them into the range
+ * all at once at the end of the input operation, with a single range
+ * <tt>insert()</tt>. For ranges like \c std::vector and
+ * \c std::basic_string , that is much faster when inserting many
+ * values anywhere but at the end.
+ * 
+ * \param   r   The range to write values to.
+ * \param   i   The iterator referencing the position in the range to begin
+ *              inserting values to.
+ * 
+ * \tparam  Range     The range type to read into.
+ * 
+ * \return  A range input operation object for the given range, with the desired
+ *          behaviour.
+ */
+template <typename Range, typename Iterator>
+auto bulk_insert(Range& r, Iterator i) ->
+  rangeio_detail::range_input_operation<Range, Iterator, rangeio_detail::bulk_insert_behaviour<Range, Iterator>>
+{
+  return input(r, i, rangeio_detail::bulk_insert_behaviour<Range, Iterator>{});
+}
+
+/** Bulk insert range input function.
+ * 
+ * \param   r   The range to write values to.
+ * \param   i   The iterator referencing the position in the range to begin
+ *              inserting values to.
+ * \param   n   The maximum number of values to read in a single input op.
+ * 
+ * \tparam  Range     The range type to read into.
+ * 
+ * \return  A range input operation object for the given range, with the desired
+ *          behaviour.
+ */
+template <typename Range, typename Iterator>
+auto bulk_insert_n(Range& r, Iterator i, size_t n) ->
+  rangeio_detail::range_input_operation<Range, Iterator, rangeio_detail::bulk_insert_behaviour<Range, Iterator>>
+{
+  return input(r, i, rangeio_detail::bulk_insert_behaviour<Range, Iterator>{n});
+}
+
 } // namespace std
 
 #endif // STD_RANGEIO_insert_
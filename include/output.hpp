@@ -18,47 +18,268 @@
 
 #include <initializer_list>
 #include <iosfwd>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
 #include <utility>
 
+#include "direct-output.hpp"
+#include "range-traits.hpp"
 #include "stream-formatting-saver.hpp"
 
 namespace std {
+
+/** Tag type to request floating point output in the shortest form
+ * that round-trips.
+ */
+struct shortest_round_trip_t
+{
+  explicit shortest_round_trip_t() = default;
+};
+
+constexpr shortest_round_trip_t shortest_round_trip{};
+
 namespace rangeio_detail {
 
-template <typename Range, typename Iterator = decltype(begin(declval<Range&>()))>
+/* 
+ * The parallel formatting options of range writers that never format
+ * in parallel. Parallel formatting is opt-in, and only available to
+ * range writers created by the overloads of write_all() in
+ * <rangeio_parallel>.
+ */
+struct no_parallel_formatting {};
+
+/* 
+ * This is a helper class that raises the precision of a stream for as long
+ * as it exists, so that floating point values of type T written with it read
+ * back to the same value. That only matters for values that can't be written
+ * in the shortest form directly, because the stream's locale or formatting
+ * state can't be reproduced; those are written by their inserters with
+ * max_digits10 significant digits instead. In fixed notation, that is
+ * only enough for values of at least 0.1, so the precision of smaller values
+ * is raised further as they are written (see fixed_round_trip_precision()).
+ */
+template <typename T, typename CharT, typename Traits>
+struct round_trip_precision
+{
+  round_trip_precision(basic_ios<CharT, Traits>& s, bool enable) :
+    stream_{s},
+    precision_{s.precision()}
+  {
+    if (enable && is_floating_point<T>::value)
+    {
+      auto const scientific = (s.flags() & ios_base::floatfield) == ios_base::scientific;
+      s.precision(numeric_limits<T>::max_digits10 - (scientific ? 1 : 0));
+    }
+  }
+  
+  ~round_trip_precision()
+  {
+    stream_.precision(precision_);
+  }
+  
+  basic_ios<CharT, Traits>& stream_;
+  streamsize const precision_;
+};
+
+template <typename Range, typename Iterator = decltype(begin(declval<Range&>())), typename Parallel = no_parallel_formatting>
 struct range_writer
 {
-  explicit range_writer(Range&& r) :
-    range_{forward<Range>(r)}
+  explicit range_writer(Range&& r, bool shortest = false, Parallel parallel = Parallel{}) :
+    range_{forward<Range>(r)},
+    shortest_{shortest},
+    parallel_{parallel}
   {
     next = begin(range_);
   }
   
   Range range_;
+  bool shortest_;
+  Parallel parallel_;
   size_t count = 0;
   Iterator next;
 };
 
-template <typename Range, typename Iterator, typename CharT, typename Traits>
-auto operator<<(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator>& p) ->
+/** Helper template to detect range writers that can format their
+ * elements in parallel.
+ * 
+ * \tparam Range     The range type.
+ * \tparam Parallel  The parallel formatting options type.
+ */
+template <typename Range, typename Parallel>
+using is_parallel_writable = integral_constant<bool,
+  is_random_access_range<Range>::value && !is_same<Parallel, no_parallel_formatting>::value>;
+
+/** Writes the elements of a range in parallel, if the range writer
+ * asks for that, the range is a random access range and it is large
+ * enough. This overload is for range writers that don't; the one that
+ * does the work is in parallel-output.hpp, and is found by
+ * argument-dependent lookup if that header is included.
+ * 
+ * \return   \c true if the elements were written.
+ */
+template <typename Writer, typename CharT, typename Traits, typename Delim>
+auto write_parallel(basic_ostream<CharT, Traits>&, Writer&, output_format<CharT> const&, Delim const&, false_type) ->
+  bool
+{
+  return false;
+}
+
+/** Writes the elements of a range using their inserters.
+ * 
+ * \param  out         The stream to write to.
+ * \param  p           The range writer.
+ * \param  formatting  The saved formatting state of \a out .
+ */
+template <typename Range, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto write_elements(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator, Parallel>& p, stream_formatting_saver<CharT, Traits> const& formatting, false_type) ->
+  void
+{
+  while ((p.next != end(p.range_)) && static_cast<bool>(out))
+  {
+    formatting.template restore_for<value_type_of<Range>>();
+    
+    if ((out << *(p.next)))
+    {
+      ++p.count;
+      ++p.next;
+    }
+  }
+}
+
+/** Writes the elements of a contiguous range directly.
+ * 
+ * The elements are accessed through plain pointers.
+ * 
+ * \param  out   The stream to write to.
+ * \param  p     The range writer.
+ * \param  f     The formatting state.
+ */
+template <typename Range, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto write_direct(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator, Parallel>& p, output_format<CharT> const& f, true_type) ->
+  void
+{
+  auto const n = distance(p.next, end(p.range_));
+  auto const first = addressof(*p.next);
+  
+  try
+  {
+    write_contiguous(out, first, first + n, f, no_delimiter{}, p.count);
+  }
+  catch (...)
+  {
+    advance(p.next, p.count);
+    throw;
+  }
+  
+  advance(p.next, p.count);
+}
+
+/** Writes the elements of a non-contiguous range directly.
+ * 
+ * \param  out   The stream to write to.
+ * \param  p     The range writer.
+ * \param  f     The formatting state.
+ */
+template <typename Range, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto write_direct(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator, Parallel>& p, output_format<CharT> const& f, false_type) ->
+  void
+{
+  write_direct(out, p.next, end(p.range_), f, no_delimiter{}, p.count);
+}
+
+/** Writes the elements of a range of arithmetic values with the
+ * stream's \c num_put facet.
+ * 
+ * The facet is looked up once for the whole range, and the elements
+ * are written under a single sentry.
+ * 
+ * \param  out         The stream to write to.
+ * \param  p           The range writer.
+ * \param  formatting  The saved formatting state of \a out .
+ */
+template <typename Range, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto write_with_facet(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator, Parallel>& p, stream_formatting_saver<CharT, Traits> const& formatting, true_type) ->
+  void
+{
+  if ((p.next != end(p.range_)) && static_cast<bool>(out))
+    write_direct<streambuf_sink<CharT, Traits>>(out, p.next, end(p.range_), output_format_of(formatting, p.shortest_), no_delimiter{},
+      num_put_writer<value_type_of<Range>, CharT, Traits>{out}, p.count);
+}
+
+template <typename Range, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto write_with_facet(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator, Parallel>& p, stream_formatting_saver<CharT, Traits> const& formatting, false_type) ->
+  void
+{
+  write_elements(out, p, formatting, false_type{});
+}
+
+/** Writes the elements of a range of directly writable values.
+ * 
+ * If the stream's formatting can be reproduced, the elements are
+ * formatted directly into the stream buffer under a single sentry.
+ * Otherwise, arithmetic elements are written with the stream's
+ * \c num_put facet, and anything else falls back to using their
+ * inserters.
+ * 
+ * \param  out         The stream to write to.
+ * \param  p           The range writer.
+ * \param  formatting  The saved formatting state of \a out .
+ */
+template <typename Range, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto write_elements(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator, Parallel>& p, stream_formatting_saver<CharT, Traits> const& formatting, true_type) ->
+  void
+{
+  if (!direct_writer<value_type_of<Range>, CharT>::usable(out))
+    return write_with_facet(out, p, formatting, is_num_put_writable<value_type_of<Range>>{});
+  
+  if ((p.next != end(p.range_)) && static_cast<bool>(out))
+  {
+    auto const f = output_format_of(formatting, p.shortest_);
+    
+    if (!write_parallel(out, p, f, no_delimiter{}, is_parallel_writable<Range, Parallel>{}))
+      write_direct(out, p, f, is_contiguous_range<Range>{});
+  }
+}
+
+/** Writes the elements of a range, choosing how at compile time.
+ * 
+ * Directly writable elements are written by the true_type overload
+ * of write_elements(), arithmetic elements that can't be written
+ * directly are written with the stream's \c num_put facet, and
+ * everything else is written with the inserters.
+ * 
+ * \param  out         The stream to write to.
+ * \param  p           The range writer.
+ * \param  formatting  The saved formatting state of \a out .
+ */
+template <typename Range, typename Iterator, typename Parallel, typename CharT, typename Traits, typename NumPut>
+auto write_range(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator, Parallel>& p, stream_formatting_saver<CharT, Traits> const& formatting, true_type, NumPut) ->
+  void
+{
+  write_elements(out, p, formatting, true_type{});
+}
+
+template <typename Range, typename Iterator, typename Parallel, typename CharT, typename Traits, typename NumPut>
+auto write_range(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator, Parallel>& p, stream_formatting_saver<CharT, Traits> const& formatting, false_type, NumPut num_put) ->
+  void
+{
+  write_with_facet(out, p, formatting, num_put);
+}
+
+template <typename Range, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto operator<<(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator, Parallel>& p) ->
   basic_ostream<CharT, Traits>&
 {
   p.count = 0;
   p.next = begin(p.range_);
   
   {
+    auto const precision = round_trip_precision<value_type_of<Range>, CharT, Traits>{out, p.shortest_};
     auto const formatting = stream_formatting_saver<CharT, Traits>{out};
     
-    while ((p.next != end(p.range_)) && static_cast<bool>(out))
-    {
-      formatting.restore();
-      
-      if ((out << *(p.next)))
-      {
-        ++p.count;
-        ++p.next;
-      }
-    }
+    write_range(out, p, formatting, direct_writer<value_type_of<Range>, CharT>{}, is_num_put_writable<value_type_of<Range>>{});
     
     if (!p.count && static_cast<bool>(out))
     {
@@ -72,52 +293,273 @@ auto operator<<(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator>
   return out;
 }
 
-template <typename Range, typename Iterator, typename CharT, typename Traits>
-auto operator<<(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator>&& p) ->
+template <typename Range, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto operator<<(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator, Parallel>&& p) ->
   basic_ostream<CharT, Traits>&
 {
   return out << p;
 }
 
-template <typename Range, typename Delim, typename Iterator = decltype(begin(declval<Range&>()))>
+template <typename Range, typename Delim, typename Iterator = decltype(begin(declval<Range&>())), typename Parallel = no_parallel_formatting>
 struct range_writer_delimited
 {
-  explicit range_writer_delimited(Range&& r, Delim&& d) :
+  explicit range_writer_delimited(Range&& r, Delim&& d, bool shortest = false, Parallel parallel = Parallel{}) :
     range_{forward<Range>(r)},
-    delim_{forward<Delim>(d)}
+    delim_{forward<Delim>(d)},
+    shortest_{shortest},
+    parallel_{parallel}
   {
     next = begin(range_);
   }
   
   Range range_;
   Delim delim_;
+  bool shortest_;
+  Parallel parallel_;
   size_t count = 0;
   Iterator next;
 };
 
-template <typename Range, typename Delim, typename Iterator, typename CharT, typename Traits>
-auto operator<<(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range, Delim, Iterator>& p) ->
+/** Helper template for the pre-rendered delimiter of a delimited range writer.
+ * 
+ * \tparam Delim   The delimiter type (possibly a reference).
+ * \tparam CharT   The character type of the stream.
+ * \tparam Traits  The character traits of the stream.
+ */
+template <typename Delim, typename CharT, typename Traits>
+using rendered_delimiter_of = rendered_delimiter<typename decay<Delim>::type, CharT, Traits>;
+
+/** Writes a delimiter that could not be pre-rendered.
+ * 
+ * \param  out     The stream to write to.
+ * \param  d       The delimiter.
+ */
+template <typename Delim, typename CharT, typename Traits>
+auto write_delimiter(basic_ostream<CharT, Traits>& out, Delim& d, rendered_delimiter_of<Delim, CharT, Traits> const&, false_type) ->
+  void
+{
+  out << d;
+}
+
+/** Writes a pre-rendered delimiter.
+ * 
+ * The rendered delimiter is written straight to the stream buffer,
+ * unless the stream has a width set (which can only happen if the
+ * element inserter didn't reset it), in which case the delimiter's
+ * inserter is used so it gets padded.
+ * 
+ * \param  out       The stream to write to.
+ * \param  d         The delimiter.
+ * \param  rendered  The pre-rendered delimiter.
+ */
+template <typename Delim, typename CharT, typename Traits>
+auto write_delimiter(basic_ostream<CharT, Traits>& out, Delim& d, rendered_delimiter_of<Delim, CharT, Traits> const& rendered, true_type) ->
+  void
+{
+  if (out.width() || !rendered.usable())
+  {
+    out << d;
+    return;
+  }
+  
+  try
+  {
+    auto sink = streambuf_sink<CharT, Traits>{*out.rdbuf()};
+    
+    if (!rendered.write(sink))
+      out.setstate(ios_base::badbit);
+  }
+  catch (...)
+  {
+    handle_output_exception(out);
+  }
+}
+
+/** Writes the elements of a range using their inserters.
+ * 
+ * \param  out         The stream to write to.
+ * \param  p           The range writer.
+ * \param  formatting  The saved formatting state of \a out .
+ * \param  rendered    The pre-rendered delimiter.
+ */
+template <typename Range, typename Delim, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto write_elements(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range, Delim, Iterator, Parallel>& p, stream_formatting_saver<CharT, Traits> const& formatting,
+    rendered_delimiter_of<Delim, CharT, Traits> const& rendered, false_type) ->
+  void
+{
+  while ((p.next != end(p.range_)) && static_cast<bool>(out))
+  {
+    // The delimiter is written between elements, so its inserter
+    // can change the formatting state too.
+    if (has_standard_formatting<typename decay<Delim>::type>::value)
+      formatting.template restore_for<value_type_of<Range>>();
+    else
+      formatting.restore();
+    
+    if ((out << *(p.next)))
+    {
+      ++p.count;
+      ++p.next;
+      
+      if (p.next != end(p.range_))
+        write_delimiter(out, p.delim_, rendered, integral_constant<bool, rendered_delimiter_of<Delim, CharT, Traits>::value>{});
+    }
+  }
+}
+
+/** Writes the elements of a contiguous range directly.
+ * 
+ * \param  out       The stream to write to.
+ * \param  p         The range writer.
+ * \param  f         The formatting state.
+ * \param  rendered  The pre-rendered delimiter.
+ */
+template <typename Range, typename Delim, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto write_direct(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range, Delim, Iterator, Parallel>& p, output_format<CharT> const& f,
+    rendered_delimiter_of<Delim, CharT, Traits> const& rendered, true_type) ->
+  void
+{
+  auto const n = distance(p.next, end(p.range_));
+  auto const first = addressof(*p.next);
+  
+  try
+  {
+    write_contiguous(out, first, first + n, f, rendered, p.count);
+  }
+  catch (...)
+  {
+    advance(p.next, p.count);
+    throw;
+  }
+  
+  advance(p.next, p.count);
+}
+
+/** Writes the elements of a non-contiguous range directly.
+ * 
+ * \param  out       The stream to write to.
+ * \param  p         The range writer.
+ * \param  f         The formatting state.
+ * \param  rendered  The pre-rendered delimiter.
+ */
+template <typename Range, typename Delim, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto write_direct(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range, Delim, Iterator, Parallel>& p, output_format<CharT> const& f,
+    rendered_delimiter_of<Delim, CharT, Traits> const& rendered, false_type) ->
+  void
+{
+  write_direct(out, p.next, end(p.range_), f, rendered, p.count);
+}
+
+/** Writes the elements of a range of arithmetic values with the
+ * stream's \c num_put facet.
+ * 
+ * The facet is looked up once for the whole range, and the elements
+ * and delimiters are written under a single sentry.
+ * 
+ * \param  out         The stream to write to.
+ * \param  p           The range writer.
+ * \param  formatting  The saved formatting state of \a out .
+ * \param  rendered    The pre-rendered delimiter.
+ */
+template <typename Range, typename Delim, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto write_with_facet(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range, Delim, Iterator, Parallel>& p, stream_formatting_saver<CharT, Traits> const& formatting,
+    rendered_delimiter_of<Delim, CharT, Traits> const& rendered, true_type) ->
+  void
+{
+  if ((p.next != end(p.range_)) && static_cast<bool>(out))
+    write_direct<streambuf_sink<CharT, Traits>>(out, p.next, end(p.range_), output_format_of(formatting, p.shortest_), rendered,
+      num_put_writer<value_type_of<Range>, CharT, Traits>{out}, p.count);
+}
+
+template <typename Range, typename Delim, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto write_with_facet(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range, Delim, Iterator, Parallel>& p, stream_formatting_saver<CharT, Traits> const& formatting,
+    rendered_delimiter_of<Delim, CharT, Traits> const& rendered, false_type) ->
+  void
+{
+  write_elements(out, p, formatting, rendered, false_type{});
+}
+
+/** Writes the elements of a range of directly writable values.
+ * 
+ * If the delimiter could be rendered and the stream's formatting
+ * can be reproduced, the elements and delimiters are written
+ * directly into the stream buffer under a single sentry. If only
+ * the delimiter could be rendered, arithmetic elements are written
+ * with the stream's \c num_put facet. Anything else falls back to
+ * using the inserters.
+ * 
+ * \param  out         The stream to write to.
+ * \param  p           The range writer.
+ * \param  formatting  The saved formatting state of \a out .
+ * \param  rendered    The pre-rendered delimiter.
+ */
+template <typename Range, typename Delim, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto write_elements(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range, Delim, Iterator, Parallel>& p, stream_formatting_saver<CharT, Traits> const& formatting,
+    rendered_delimiter_of<Delim, CharT, Traits> const& rendered, true_type) ->
+  void
+{
+  if (!rendered.usable())
+    return write_elements(out, p, formatting, rendered, false_type{});
+  
+  if (!direct_writer<value_type_of<Range>, CharT>::usable(out))
+    return write_with_facet(out, p, formatting, rendered, is_num_put_writable<value_type_of<Range>>{});
+  
+  if ((p.next != end(p.range_)) && static_cast<bool>(out))
+  {
+    auto const f = output_format_of(formatting, p.shortest_);
+    
+    if (!write_parallel(out, p, f, rendered, is_parallel_writable<Range, Parallel>{}))
+      write_direct(out, p, f, rendered, is_contiguous_range<Range>{});
+  }
+}
+
+/** Writes the elements of a range, choosing how at compile time.
+ * 
+ * If the delimiter can be pre-rendered, directly writable elements
+ * are written by the true_type overload of write_elements(), and
+ * arithmetic elements that can't be written directly are written
+ * with the stream's \c num_put facet. Everything else is written
+ * with the inserters.
+ * 
+ * \param  out         The stream to write to.
+ * \param  p           The range writer.
+ * \param  formatting  The saved formatting state of \a out .
+ * \param  rendered    The pre-rendered delimiter.
+ */
+template <typename Range, typename Delim, typename Iterator, typename Parallel, typename CharT, typename Traits, typename NumPut>
+auto write_range(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range, Delim, Iterator, Parallel>& p, stream_formatting_saver<CharT, Traits> const& formatting,
+    rendered_delimiter_of<Delim, CharT, Traits> const& rendered, true_type, NumPut) ->
+  void
+{
+  write_elements(out, p, formatting, rendered, true_type{});
+}
+
+template <typename Range, typename Delim, typename Iterator, typename Parallel, typename CharT, typename Traits, typename NumPut>
+auto write_range(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range, Delim, Iterator, Parallel>& p, stream_formatting_saver<CharT, Traits> const& formatting,
+    rendered_delimiter_of<Delim, CharT, Traits> const& rendered, false_type, NumPut num_put) ->
+  void
+{
+  if (!rendered.usable())
+    return write_elements(out, p, formatting, rendered, false_type{});
+  
+  write_with_facet(out, p, formatting, rendered, num_put);
+}
+
+template <typename Range, typename Delim, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto operator<<(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range, Delim, Iterator, Parallel>& p) ->
   basic_ostream<CharT, Traits>&
 {
   p.count = 0;
   p.next = begin(p.range_);
   
   {
+    auto const precision = round_trip_precision<value_type_of<Range>, CharT, Traits>{out, p.shortest_};
     auto const formatting = stream_formatting_saver<CharT, Traits>{out};
+    auto const rendered = rendered_delimiter_of<Delim, CharT, Traits>{out, p.delim_};
     
-    while ((p.next != end(p.range_)) && static_cast<bool>(out))
-    {
-      formatting.restore();
-      
-      if ((out << *(p.next)))
-      {
-        ++p.count;
-        ++p.next;
-        
-        if (p.next != end(p.range_))
-          out << p.delim_;
-      }
-    }
+    write_range(out, p, formatting, rendered,
+      integral_constant<bool, direct_writer<value_type_of<Range>, CharT>::value && rendered_delimiter_of<Delim, CharT, Traits>::value>{},
+      integral_constant<bool, is_num_put_writable<value_type_of<Range>>::value && rendered_delimiter_of<Delim, CharT, Traits>::value>{});
     
     if (!p.count && static_cast<bool>(out))
     {
@@ -131,8 +573,8 @@ auto operator<<(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range,
   return out;
 }
 
-template <typename Range, typename Delim, typename Iterator, typename CharT, typename Traits>
-auto operator<<(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range, Delim, Iterator>&& p) ->
+template <typename Range, typename Delim, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto operator<<(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range, Delim, Iterator, Parallel>&& p) ->
   basic_ostream<CharT, Traits>&
 {
   return out << p;
@@ -168,6 +610,37 @@ auto write_all(std::initializer_list<T>&& r, Delim&& d) ->
   return rangeio_detail::range_writer_delimited<std::initializer_list<T>&&, Delim&&>{forward<std::initializer_list<T>>(r), forward<Delim>(d)};
 }
 
+template <typename Range>
+auto write_all(shortest_round_trip_t, Range&& r) ->
+  rangeio_detail::range_writer<Range&&>
+{
+  return rangeio_detail::range_writer<Range&&>{forward<Range>(r), true};
+}
+
+template <typename T>
+auto write_all(shortest_round_trip_t, std::initializer_list<T>&& r) ->
+  rangeio_detail::range_writer<std::initializer_list<T>&&>
+{
+  return rangeio_detail::range_writer<std::initializer_list<T>&&>{forward<std::initializer_list<T>>(r), true};
+}
+
+template <typename Range, typename Delim>
+auto write_all(shortest_round_trip_t, Range&& r, Delim&& d) ->
+  rangeio_detail::range_writer_delimited<Range&&, Delim&&>
+{
+  return rangeio_detail::range_writer_delimited<Range&&, Delim&&>{forward<Range>(r), forward<Delim>(d), true};
+}
+
+template <typename T, typename Delim>
+auto write_all(shortest_round_trip_t, std::initializer_list<T>&& r, Delim&& d) ->
+  rangeio_detail::range_writer_delimited<std::initializer_list<T>&&, Delim&&>
+{
+  return rangeio_detail::range_writer_delimited<std::initializer_list<T>&&, Delim&&>{forward<std::initializer_list<T>>(r), forward<Delim>(d), true};
+}
+
 } // namespace std
 
+#include "write_to.hpp"
+#include "write_binary.hpp"
+
 #endif  // STD_RANGEIO_output_
@@ -28,6 +28,9 @@ namespace rangeio_detail {
 template <typename Range>
 struct overwrite_behaviour
 {
+  //! The type of the values read from the stream.
+  using value_type = value_type_of<Range>;
+  
   /** Prepares the input operation.
    * 
    * Simply returns \c true if the range is not empty, and gives \c begin(r) as
@@ -52,9 +55,10 @@ struct overwrite_behaviour
    * If \a i is not equal to <tt>end(r)</tt>, reads an formats a value from
    * \a in , storing it in <tt>*i</tt>, then increments \a i .
    * 
-   * \param  in  The stream being read.
-   * \param  r   The range being read into.
-   * \param  i   An iterator to the next location in the range to read into.
+   * \param  in      The stream being read.
+   * \param  r       The range being read into.
+   * \param  i       An iterator to the next location in the range to read into.
+   * \param  source  The input source to read the value with.
    * 
    * \tparam CharT   The character type of the stream being read.
    * \tparam Traits  The character traits of the stream being read.
@@ -68,17 +72,73 @@ struct overwrite_behaviour
    *               if it was not stored.
    */
   template <typename CharT, typename Traits>
-  auto read(basic_istream<CharT, Traits>& in, Range& r, iterator_type_of<Range> i) ->
+  auto read(basic_istream<CharT, Traits>& in, Range& r, iterator_type_of<Range> i, input_source<CharT, Traits>& source) ->
     tuple<bool, iterator_type_of<Range>, bool, bool>
   {
-    if (i != end(r) && (in >> *i))
+    auto const result = read_bulk(in, r, i, source, 1);
+    
+    return make_tuple(get<0>(result), get<1>(result), get<2>(result) != 0, get<3>(result) != 0);
+  }
+  
+  /** Reads several values from the stream and stores them in the range.
+   * 
+   * Does what read() does, for up to \a max values.
+   * 
+   * \param  in      The stream being read.
+   * \param  r       The range being read into.
+   * \param  i       An iterator to the next location in the range to read into.
+   * \param  source  The input source to read the values with.
+   * \param  max     The maximum number of values to read.
+   * 
+   * \tparam CharT   The character type of the stream being read.
+   * \tparam Traits  The character traits of the stream being read.
+   * 
+   * \return   A tuple containing:
+   *             - \c true if \a max values were read and
+   *               <tt>i != end(r)</tt>, \c false otherwise.
+   *             - the value that \c next should be set to.
+   *             - the number of values read.
+   *             - the number of values read.
+   */
+  template <typename CharT, typename Traits>
+  auto read_bulk(basic_istream<CharT, Traits>&, Range& r, iterator_type_of<Range> i, input_source<CharT, Traits>& source, size_t max) ->
+    tuple<bool, iterator_type_of<Range>, size_t, size_t>
+  {
+    auto const last = end(r);
+    auto n = size_t{0};
+    
+    try
     {
-      ++i;
-      return make_tuple(bool(i != end(r)), i, true, true);
+      while ((n != max) && (i != last) && source.extract(*i))
+      {
+        ++i;
+        ++n;
+      }
+    }
+    catch (...)
+    {
+      progress_ = make_tuple(i, n, n);
+      throw;
     }
     
-    return make_tuple(false, i, false, false);
+    return make_tuple((n == max) && (i != last), i, n, n);
   }
+  
+  /** Gets how far the last call to read_bulk() got before it threw.
+   * 
+   * \return   A tuple containing:
+   *             - the value that \c next should be set to.
+   *             - the number of values read.
+   *             - the number of values read.
+   */
+  auto progress_after_exception() ->
+    tuple<iterator_type_of<Range>, size_t, size_t>
+  {
+    return progress_;
+  }
+  
+  //! How far the last call to read_bulk() got, if it threw.
+  tuple<iterator_type_of<Range>, size_t, size_t> progress_;
 };
 
 } // namespace rangeio_detail
@@ -0,0 +1,452 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STD_RANGEIO_parallel_output_
+#define STD_RANGEIO_parallel_output_
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <initializer_list>
+#include <ios>
+#include <iterator>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "direct-output.hpp"
+#include "output.hpp"
+
+namespace std {
+
+/** Options to request that large ranges are formatted in parallel.
+ * 
+ * Random access ranges with at least \c threshold elements are split
+ * into chunks, which are formatted on \c threads worker threads (or
+ * one per hardware thread, if \c threads is zero), and written to
+ * the stream in order. The output is exactly the same as without
+ * these options. This is only done for elements and delimiters
+ * that can be written directly; anything else is written
+ * sequentially.
+ */
+struct parallel_formatting
+{
+  explicit parallel_formatting(size_t threshold = size_t{1} << 20, unsigned threads = 0) :
+    threshold{threshold},
+    threads{threads}
+  {}
+  
+  size_t threshold;
+  unsigned threads;
+};
+
+namespace rangeio_detail {
+
+//! The number of elements in each chunk of a range formatted in parallel.
+constexpr size_t parallel_chunk_size = 8192;
+
+/** Output sink that collects output in memory.
+ * 
+ * The ends of the elements are recorded, so that if the stream
+ * buffer only takes part of the output, the elements that made it
+ * there completely can still be counted.
+ * 
+ * \tparam CharT   The character type.
+ * \tparam Traits  The character traits.
+ */
+template <typename CharT, typename Traits>
+struct chunk_sink
+{
+  using traits_type = Traits;
+  
+  auto put(CharT const* s, streamsize n) -> bool
+  {
+    text_.append(s, static_cast<size_t>(n));
+    return true;
+  }
+  
+  auto put(CharT c) -> bool
+  {
+    text_.push_back(c);
+    return true;
+  }
+  
+  auto fill(CharT c, streamsize n) -> bool
+  {
+    text_.append(static_cast<size_t>(n), c);
+    return true;
+  }
+  
+  auto end_element() -> bool
+  {
+    ends_.push_back(text_.size());
+    return true;
+  }
+  
+  /** The number of elements that end within the first \a n
+   * characters.
+   */
+  auto complete_within(size_t n) const -> size_t
+  {
+    auto count = size_t{0};
+    
+    while ((count != ends_.size()) && (ends_[count] <= n))
+      ++count;
+    
+    return count;
+  }
+  
+  basic_string<CharT, Traits> text_;
+  vector<size_t> ends_;
+};
+
+/** Formats a random access sequence of values in parallel.
+ * 
+ * The sequence is split into chunks of parallel_chunk_size
+ * elements, which worker threads format directly into memory,
+ * while the thread that owns the stream writes the formatted chunks
+ * to the stream buffer in order. Only a limited number of chunks are
+ * held in memory at a time: a worker doesn't start on a chunk until
+ * the chunk that last used its slot has been written.
+ * 
+ * The elements and delimiters are formatted exactly as write_direct()
+ * formats them, and the delimiter goes between elements, so the
+ * output, the number of elements counted as written and the state
+ * of the stream are all the same as if the sequence had been
+ * written sequentially.
+ * 
+ * \tparam Iterator  The iterator type of the sequence.
+ * \tparam CharT     The character type of the stream.
+ * \tparam Traits    The character traits of the stream.
+ * \tparam Delim     The rendered delimiter type.
+ */
+template <typename Iterator, typename CharT, typename Traits, typename Delim>
+struct parallel_writer
+{
+  using writer_type = direct_writer<typename iterator_traits<Iterator>::value_type, CharT>;
+  
+  struct chunk
+  {
+    chunk_sink<CharT, Traits> sink_;
+    bool ready_ = false;
+    bool failed_ = false;
+    exception_ptr error_;
+  };
+  
+  parallel_writer(Iterator first, size_t n, output_format<CharT> const& f, Delim const& delim) :
+    first_{first},
+    size_{n},
+    chunks_{(n + parallel_chunk_size - 1) / parallel_chunk_size},
+    format_{f},
+    delim_{delim}
+  {}
+  
+  ~parallel_writer()
+  {
+    {
+      lock_guard<mutex> const lock{mutex_};
+      stopped_ = true;
+    }
+    
+    free_.notify_all();
+    
+    for (auto&& worker : workers_)
+      worker.join();
+  }
+  
+  /** Starts the worker threads.
+   * 
+   * \param  threads  The number of worker threads.
+   * 
+   * \return   \c true if at least one worker thread could be started.
+   */
+  auto start(unsigned threads) -> bool
+  {
+    slots_ = vector<chunk>(2 * size_t{threads});
+    
+    try
+    {
+      for (auto n = 0u; n != threads; ++n)
+        workers_.emplace_back(&parallel_writer::work, this);
+    }
+    catch (system_error const&)
+    {}
+    
+    return !workers_.empty();
+  }
+  
+  /** Writes the formatted chunks to a stream, in order.
+   * 
+   * Must be called under a sentry for the stream. \a count is kept
+   * up to date as each chunk is written, so it is right even if
+   * writing throws.
+   * 
+   * \param  out    The stream to write to.
+   * \param  count  Set to the number of elements written successfully.
+   */
+  auto write(basic_ostream<CharT, Traits>& out, size_t& count) -> void
+  {
+    count = 0;
+    
+    for (auto c = size_t{0}; c != chunks_; ++c)
+    {
+      auto& slot = slots_[c % slots_.size()];
+      
+      {
+        unique_lock<mutex> lock{mutex_};
+        ready_.wait(lock, [&slot] { return slot.ready_; });
+      }
+      
+      auto const& text = slot.sink_.text_;
+      auto const size = static_cast<streamsize>(text.size());
+      auto written = streamsize{0};
+      
+      try
+      {
+        written = size ? out.rdbuf()->sputn(text.data(), size) : streamsize{0};
+      }
+      catch (...)
+      {
+        handle_output_exception(out);
+      }
+      
+      if (written != size)
+      {
+        count += slot.sink_.complete_within(static_cast<size_t>(written));
+        
+        if (static_cast<bool>(out))
+          out.setstate(ios_base::badbit);
+        
+        return;
+      }
+      
+      count += slot.sink_.ends_.size();
+      
+      if (slot.failed_)
+      {
+        if (slot.error_)
+        {
+          try
+          {
+            rethrow_exception(slot.error_);
+          }
+          catch (...)
+          {
+            handle_output_exception(out);
+          }
+        }
+        else
+        {
+          out.setstate(ios_base::badbit);
+        }
+        
+        return;
+      }
+      
+      {
+        lock_guard<mutex> const lock{mutex_};
+        slot.ready_ = false;
+        ++emitted_;
+      }
+      
+      free_.notify_all();
+    }
+  }
+  
+  /** Formats chunks until there are none left, or the writer stops. */
+  auto work() -> void
+  {
+    unique_lock<mutex> lock{mutex_};
+    
+    while (true)
+    {
+      free_.wait(lock, [this] { return stopped_ || (next_ == chunks_) || (next_ < emitted_ + slots_.size()); });
+      
+      if (stopped_ || (next_ == chunks_))
+        return;
+      
+      auto const c = next_++;
+      auto& slot = slots_[c % slots_.size()];
+      
+      lock.unlock();
+      format(slot, c);
+      lock.lock();
+      
+      slot.ready_ = true;
+      ready_.notify_one();
+    }
+  }
+  
+  /** Formats a chunk into its slot. */
+  auto format(chunk& slot, size_t c) -> void
+  {
+    auto const first = c * parallel_chunk_size;
+    auto const last = (size_ - first > parallel_chunk_size) ? first + parallel_chunk_size : size_;
+    
+    slot.sink_.text_.clear();
+    slot.sink_.ends_.clear();
+    slot.failed_ = false;
+    slot.error_ = nullptr;
+    
+    try
+    {
+      auto i = first_ + static_cast<typename iterator_traits<Iterator>::difference_type>(first);
+      
+      for (auto n = first; n != last; ++n, ++i)
+      {
+        if (!writer_type::write(slot.sink_, *i, format_))
+        {
+          slot.failed_ = true;
+          return;
+        }
+        
+        slot.sink_.end_element();
+        
+        if (n + 1 != size_)
+          delim_.write(slot.sink_);
+      }
+    }
+    catch (...)
+    {
+      slot.failed_ = true;
+      slot.error_ = current_exception();
+    }
+  }
+  
+  Iterator const first_;
+  size_t const size_;
+  size_t const chunks_;
+  output_format<CharT> const& format_;
+  Delim const& delim_;
+  
+  vector<chunk> slots_;
+  vector<thread> workers_;
+  
+  mutex mutex_;
+  condition_variable ready_;
+  condition_variable free_;
+  size_t next_ = 0;
+  size_t emitted_ = 0;
+  bool stopped_ = false;
+};
+
+/** Writes a random access sequence of values directly to a stream,
+ * formatting it in parallel.
+ * 
+ * \param  out      The stream to write to.
+ * \param  next     The first value to write. On return, it references
+ *                  the first value that was not written.
+ * \param  n        The number of values to write.
+ * \param  f        The formatting state.
+ * \param  delim    The delimiter.
+ * \param  threads  The number of worker threads, or zero for one per
+ *                  hardware thread.
+ * \param  count    Set to the number of values written successfully.
+ * 
+ * \return   \c false if the sequence could not be written in parallel
+ *           (because there is only one thread to do it with), in
+ *           which case nothing is done.
+ */
+template <typename Iterator, typename CharT, typename Traits, typename Delim>
+auto write_parallel(basic_ostream<CharT, Traits>& out, Iterator& next, size_t n, output_format<CharT> const& f, Delim const& delim, unsigned threads,
+    size_t& count) -> bool
+{
+  if (!threads)
+    threads = thread::hardware_concurrency();
+  
+  if (threads < 2)
+    return false;
+  
+  parallel_writer<Iterator, CharT, Traits, Delim> writer{next, n, f, delim};
+  if (!writer.start(threads))
+    return false;
+  
+  count = 0;
+  
+  typename basic_ostream<CharT, Traits>::sentry const sentry{out};
+  if (sentry)
+  {
+    try
+    {
+      writer.write(out, count);
+    }
+    catch (...)
+    {
+      next += static_cast<typename iterator_traits<Iterator>::difference_type>(count);
+      throw;
+    }
+    
+    next += static_cast<typename iterator_traits<Iterator>::difference_type>(count);
+  }
+  
+  return true;
+}
+
+/** Writes the elements of a random access range directly, formatting
+ * them in parallel, if the range is large enough.
+ * 
+ * \param  out     The stream to write to.
+ * \param  p       The range writer.
+ * \param  f       The formatting state.
+ * \param  delim   The delimiter.
+ * 
+ * \return   \c true if the elements were written.
+ */
+template <typename Writer, typename CharT, typename Traits, typename Delim>
+auto write_parallel(basic_ostream<CharT, Traits>& out, Writer& p, output_format<CharT> const& f, Delim const& delim, true_type) ->
+  bool
+{
+  auto const n = static_cast<size_t>(distance(p.next, end(p.range_)));
+  
+  return (n >= p.parallel_.threshold) && write_parallel(out, p.next, n, f, delim, p.parallel_.threads, p.count);
+}
+
+} // namespace rangeio_detail
+
+template <typename Range>
+auto write_all(parallel_formatting parallel, Range&& r) ->
+  rangeio_detail::range_writer<Range&&, rangeio_detail::iterator_type_of<Range&&>, parallel_formatting>
+{
+  return rangeio_detail::range_writer<Range&&, rangeio_detail::iterator_type_of<Range&&>, parallel_formatting>{forward<Range>(r), false, parallel};
+}
+
+template <typename T>
+auto write_all(parallel_formatting parallel, std::initializer_list<T>&& r) ->
+  rangeio_detail::range_writer<std::initializer_list<T>&&, rangeio_detail::iterator_type_of<std::initializer_list<T>&&>, parallel_formatting>
+{
+  return rangeio_detail::range_writer<std::initializer_list<T>&&, rangeio_detail::iterator_type_of<std::initializer_list<T>&&>, parallel_formatting>{forward<std::initializer_list<T>>(r), false, parallel};
+}
+
+template <typename Range, typename Delim>
+auto write_all(parallel_formatting parallel, Range&& r, Delim&& d) ->
+  rangeio_detail::range_writer_delimited<Range&&, Delim&&, rangeio_detail::iterator_type_of<Range&&>, parallel_formatting>
+{
+  return rangeio_detail::range_writer_delimited<Range&&, Delim&&, rangeio_detail::iterator_type_of<Range&&>, parallel_formatting>{forward<Range>(r), forward<Delim>(d), false, parallel};
+}
+
+template <typename T, typename Delim>
+auto write_all(parallel_formatting parallel, std::initializer_list<T>&& r, Delim&& d) ->
+  rangeio_detail::range_writer_delimited<std::initializer_list<T>&&, Delim&&, rangeio_detail::iterator_type_of<std::initializer_list<T>&&>, parallel_formatting>
+{
+  return rangeio_detail::range_writer_delimited<std::initializer_list<T>&&, Delim&&, rangeio_detail::iterator_type_of<std::initializer_list<T>&&>, parallel_formatting>{forward<std::initializer_list<T>>(r), forward<Delim>(d), false, parallel};
+}
+
+} // namespace std
+
+#endif  // STD_RANGEIO_parallel_output_
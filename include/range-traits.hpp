@@ -0,0 +1,112 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STD_RANGEIO_range_traits_
+#define STD_RANGEIO_range_traits_
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace std {
+namespace rangeio_detail {
+
+/** Helper template to deduce the iterator type of a range.
+ * 
+ * \tparam Range  The range to deduce the iterator type of.
+ */
+template <typename Range>
+using iterator_type_of = decltype(begin(declval<Range&>()));
+
+/** Helper template to deduce the value type of a range.
+ * 
+ * \tparam Range  The range to deduce the value type of.
+ */
+template <typename Range>
+using value_type_of = typename iterator_traits<iterator_type_of<Range>>::value_type;
+
+/** Helper template to detect ranges with contiguous storage.
+ * 
+ * A range is considered contiguous if its iterators are plain
+ * pointers (built-in arrays, initializer lists), or if they are
+ * random access iterators and the range has a <tt>data()</tt>
+ * member function that returns a pointer to the value type (like
+ * \c std::vector , \c std::array and \c std::basic_string ).
+ * 
+ * \tparam Range  The range type to check.
+ */
+template <typename Range, typename = void>
+struct is_contiguous_range :
+  is_pointer<iterator_type_of<Range>>
+{};
+
+template <typename Range>
+struct is_contiguous_range<Range, decltype(void(declval<Range&>().data()))> :
+  integral_constant<bool,
+    is_pointer<iterator_type_of<Range>>::value ||
+    (is_base_of<random_access_iterator_tag, typename iterator_traits<iterator_type_of<Range>>::iterator_category>::value &&
+     is_same<typename remove_cv<typename remove_pointer<decltype(declval<Range&>().data())>::type>::type, value_type_of<Range>>::value)>
+{};
+
+/** Helper template to detect ranges with random access iterators.
+ * 
+ * \tparam Range  The range type to check.
+ */
+template <typename Range>
+struct is_random_access_range :
+  is_base_of<random_access_iterator_tag, typename iterator_traits<iterator_type_of<Range>>::iterator_category>
+{};
+
+/** Helper template to detect ranges that can reserve space for
+ * elements, and report how much they have, like \c std::vector and
+ * \c std::basic_string .
+ * 
+ * \tparam Range  The range type to check.
+ */
+template <typename Range, typename = void>
+struct has_reserve :
+  false_type
+{};
+
+template <typename Range>
+struct has_reserve<Range, decltype(void(declval<Range&>().reserve(declval<Range&>().size())), void(declval<Range&>().capacity()))> :
+  true_type
+{};
+
+/** Helper template to detect the character types.
+ * 
+ * Character types are integral, but they are read and written as
+ * characters rather than numbers.
+ * 
+ * \tparam T  The type to check.
+ */
+template <typename T>
+struct is_character :
+  integral_constant<bool,
+    is_same<T, char>::value ||
+    is_same<T, signed char>::value ||
+    is_same<T, unsigned char>::value ||
+    is_same<T, wchar_t>::value ||
+#ifdef __cpp_char8_t
+    is_same<T, char8_t>::value ||
+#endif
+    is_same<T, char16_t>::value ||
+    is_same<T, char32_t>::value>
+{};
+
+} // namespace rangeio_detail
+} // namespace std
+
+#endif  // STD_RANGEIO_range_traits_
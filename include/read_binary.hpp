@@ -0,0 +1,422 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef STD_RANGEIO_read_binary_
+#define STD_RANGEIO_read_binary_
+
+#include <algorithm>
+#include <cstring>
+#include <ios>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+
+#include "input.hpp"
+
+namespace std {
+namespace rangeio_detail {
+
+//! The number of stream characters staged at a time when reading
+//! values that mustn't be written over by a value cut short.
+constexpr size_t binary_read_stage_size = 8192;
+
+/** Reads characters straight from a stream's buffer.
+ * 
+ * If the stream ends before all the characters have been read,
+ * \c eofbit and \c failbit are set, just as with <tt>read()</tt>. If
+ * the stream buffer throws, \c badbit is set instead.
+ * 
+ * \param  in  The stream being read.
+ * \param  s   The characters to read into.
+ * \param  n   The number of characters to read.
+ * 
+ * \tparam CharT   The character type of the stream being read.
+ * \tparam Traits  The character traits of the stream being read.
+ * 
+ * \return   The number of characters read.
+ */
+template <typename CharT, typename Traits>
+auto read_characters(basic_istream<CharT, Traits>& in, CharT* s, streamsize n) -> streamsize
+{
+  auto got = streamsize{0};
+  
+  try
+  {
+    got = in.rdbuf()->sgetn(s, n);
+  }
+  catch (...)
+  {
+    handle_input_exception(in);
+    return 0;
+  }
+  
+  if (got != n)
+    in.setstate(ios_base::eofbit | ios_base::failbit);
+  
+  return got;
+}
+
+/** Reads the object representations of values from a stream,
+ * straight into the values.
+ * 
+ * The values are read with a single call to <tt>sgetn()</tt> on the
+ * stream buffer. The characters of a value cut short by the end of
+ * the stream are consumed, and written over the value following the
+ * ones that were read, so that value must be of no interest to the
+ * caller.
+ * 
+ * \param  in     The stream being read.
+ * \param  p      The values to read into.
+ * \param  n      The number of values to read.
+ * \param  count  Set to the number of whole values read.
+ * 
+ * \tparam T       The type of the values read.
+ * \tparam CharT   The character type of the stream being read.
+ * \tparam Traits  The character traits of the stream being read.
+ */
+template <typename T, typename CharT, typename Traits>
+auto read_object_representations(basic_istream<CharT, Traits>& in, T* p, size_t n, size_t& count, true_type) -> void
+{
+  static_assert(is_trivially_copyable<T>::value, "binary input needs trivially copyable values");
+  static_assert((sizeof(T) % sizeof(CharT)) == 0, "binary input needs values made of whole stream characters");
+  
+  constexpr auto chars_per_value = sizeof(T) / sizeof(CharT);
+  
+  count = 0;
+  
+  // Same as the sentry for unformatted input.
+  if (!in.good())
+  {
+    in.setstate(ios_base::failbit);
+    return;
+  }
+  
+  auto const got = read_characters(in, reinterpret_cast<CharT*>(p), static_cast<streamsize>(n * chars_per_value));
+  
+  count = static_cast<size_t>(got) / chars_per_value;
+}
+
+/** Reads the object representations of values from a stream,
+ * through a buffer.
+ * 
+ * The values are read a block at a time with <tt>sgetn()</tt>, and
+ * only whole values are copied out of the block, so a value cut short
+ * by the end of the stream is consumed without touching any of the
+ * values in \a p . \a count is kept up to date as each block is
+ * copied, so it is right even if reading throws.
+ * 
+ * \param  in     The stream being read.
+ * \param  p      The values to read into.
+ * \param  n      The number of values to read.
+ * \param  count  Set to the number of whole values read.
+ * 
+ * \tparam T       The type of the values read.
+ * \tparam CharT   The character type of the stream being read.
+ * \tparam Traits  The character traits of the stream being read.
+ */
+template <typename T, typename CharT, typename Traits>
+auto read_object_representations(basic_istream<CharT, Traits>& in, T* p, size_t n, size_t& count, false_type) -> void
+{
+  static_assert(is_trivially_copyable<T>::value, "binary input needs trivially copyable values");
+  static_assert((sizeof(T) % sizeof(CharT)) == 0, "binary input needs values made of whole stream characters");
+  
+  constexpr auto chars_per_value = sizeof(T) / sizeof(CharT);
+  constexpr auto values_per_block = (binary_read_stage_size / chars_per_value) ? (binary_read_stage_size / chars_per_value) : 1;
+  
+  count = 0;
+  
+  // Same as the sentry for unformatted input.
+  if (!in.good())
+  {
+    in.setstate(ios_base::failbit);
+    return;
+  }
+  
+  CharT block[values_per_block * chars_per_value];
+  
+  while (count != n)
+  {
+    auto const wanted = static_cast<streamsize>(min(n - count, values_per_block) * chars_per_value);
+    auto const got = read_characters(in, block, wanted);
+    auto const values = static_cast<size_t>(got) / chars_per_value;
+    
+    memcpy(p + count, block, values * sizeof(T));
+    count += values;
+    
+    if (got != wanted)
+      break;
+  }
+}
+
+/** Binary overwriting range input behaviour type.
+ * 
+ * \tparam Range     The contiguous range type being overwritten.
+ */
+template <typename Range>
+struct binary_overwrite_behaviour
+{
+  static_assert(is_contiguous_range<Range>::value, "binary input needs a contiguous range");
+  
+  //! The type of the values read from the stream.
+  using value_type = value_type_of<Range>;
+  
+  /** Prepares the input operation.
+   * 
+   * \param  r   The range being read into.
+   * \param  i   Unused.
+   * 
+   * \return   A tuple containing:
+   *             - \c true if the range is not empty, \c false if it
+   *               is.
+   *             - <tt>begin(r)</tt>.
+   */
+  auto prepare(Range& r, iterator_type_of<Range>) ->
+    tuple<bool, iterator_type_of<Range>>
+  {
+    return make_tuple(begin(r) != end(r), begin(r));
+  }
+  
+  /** Reads the object representations of several values from the
+   * stream into the range.
+   * 
+   * The values are read through a buffer, so a value cut short by
+   * the end of the stream leaves the rest of the range untouched.
+   * 
+   * \param  in      The stream being read.
+   * \param  r       The range being read into.
+   * \param  i       An iterator to the next location in the range to
+   *                 read into.
+   * \param  source  Unused.
+   * \param  max     The maximum number of values to read.
+   * 
+   * \tparam CharT   The character type of the stream being read.
+   * \tparam Traits  The character traits of the stream being read.
+   * 
+   * \return   A tuple containing:
+   *             - \c true if \a max values were read and
+   *               <tt>i != end(r)</tt>, \c false otherwise.
+   *             - the value that \c next should be set to.
+   *             - the number of values read.
+   *             - the number of values read.
+   */
+  template <typename CharT, typename Traits>
+  auto read_bulk(basic_istream<CharT, Traits>& in, Range& r, iterator_type_of<Range> i, input_source<CharT, Traits>&, size_t max) ->
+    tuple<bool, iterator_type_of<Range>, size_t, size_t>
+  {
+    using difference_type = typename iterator_traits<iterator_type_of<Range>>::difference_type;
+    
+    auto const wanted = min(max, static_cast<size_t>(end(r) - i));
+    auto n = size_t{0};
+    
+    try
+    {
+      read_object_representations(in, &*i, wanted, n, false_type{});
+    }
+    catch (...)
+    {
+      progress_ = make_tuple(i + static_cast<difference_type>(n), n, n);
+      throw;
+    }
+    
+    i += static_cast<difference_type>(n);
+    
+    return make_tuple((n == max) && (i != end(r)), i, n, n);
+  }
+  
+  /** Gets how far the last call to read_bulk() got before it threw.
+   * 
+   * \return   A tuple containing:
+   *             - the value that \c next should be set to.
+   *             - the number of values read.
+   *             - the number of values read.
+   */
+  auto progress_after_exception() ->
+    tuple<iterator_type_of<Range>, size_t, size_t>
+  {
+    return progress_;
+  }
+  
+  //! How far the last call to read_bulk() got, if it threw.
+  tuple<iterator_type_of<Range>, size_t, size_t> progress_;
+};
+
+/** Binary back inserting range input behaviour type.
+ * 
+ * \tparam Range     The contiguous range type being appended to.
+ */
+template <typename Range>
+struct binary_back_insert_behaviour
+{
+  static_assert(is_contiguous_range<Range>::value, "binary input needs a contiguous range");
+  
+  //! The type of the values read from the stream.
+  using value_type = value_type_of<Range>;
+  
+  /** Constructs a binary back insert behaviour object.
+   * 
+   * \param   n   The number of elements to read in a single read
+   *              operation.
+   */
+  explicit binary_back_insert_behaviour(size_t n) :
+    n_{n}
+  {}
+  
+  /** Prepares the input operation.
+   * 
+   * \param  r   The range being read into.
+   * \param  i   Unused.
+   * 
+   * \return   A tuple containing:
+   *             - \c true if there are any values to read, \c false
+   *               otherwise.
+   *             - <tt>end(r)</tt>.
+   */
+  auto prepare(Range& r, iterator_type_of<Range>) ->
+    tuple<bool, iterator_type_of<Range>>
+  {
+    current_ = 0;
+    
+    return make_tuple(n_ != 0, end(r));
+  }
+  
+  /** Reads the object representations of several values from the
+   * stream, appending them to the range.
+   * 
+   * The range is resized to make room for the values, which are read
+   * straight into it, then resized back down to just the values that
+   * were read - even if reading throws.
+   * 
+   * \param  in      The stream being read.
+   * \param  r       The range being read into.
+   * \param  i       Unused.
+   * \param  source  Unused.
+   * \param  max     The maximum number of values to read.
+   * 
+   * \tparam CharT   The character type of the stream being read.
+   * \tparam Traits  The character traits of the stream being read.
+   * 
+   * \return   A tuple containing:
+   *             - \c true if \a max values were read, and more can be,
+   *               \c false otherwise.
+   *             - <tt>end(r)</tt>.
+   *             - the number of values read.
+   *             - the number of values read.
+   */
+  template <typename CharT, typename Traits>
+  auto read_bulk(basic_istream<CharT, Traits>& in, Range& r, iterator_type_of<Range>, input_source<CharT, Traits>&, size_t max) ->
+    tuple<bool, iterator_type_of<Range>, size_t, size_t>
+  {
+    auto const wanted = min(max, n_ - current_);
+    auto const size = r.size();
+    
+    auto n = size_t{0};
+    
+    r.resize(size + wanted);
+    
+    try
+    {
+      read_object_representations(in, r.data() + size, wanted, n, true_type{});
+    }
+    catch (...)
+    {
+      r.resize(size);
+      progress_ = make_tuple(end(r), size_t{0}, size_t{0});
+      throw;
+    }
+    
+    r.resize(size + n);
+    
+    current_ += n;
+    
+    return make_tuple((n == max) && (current_ < n_), end(r), n, n);
+  }
+  
+  /** Gets how far the last call to read_bulk() got before it threw.
+   * 
+   * \return   A tuple containing:
+   *             - <tt>end(r)</tt>.
+   *             - zero.
+   *             - zero.
+   */
+  auto progress_after_exception() ->
+    tuple<iterator_type_of<Range>, size_t, size_t>
+  {
+    return progress_;
+  }
+  
+  //! The number of elements to read in a single read operation.
+  size_t const n_ = numeric_limits<size_t>::max();
+  
+  //! The number of elements read so far in the current read operation.
+  size_t current_ = 0;
+  
+  //! How far the last call to read_bulk() got, if it threw.
+  tuple<iterator_type_of<Range>, size_t, size_t> progress_;
+};
+
+} // namespace rangeio_detail
+
+/** Binary overwrite range input function.
+ * 
+ * Reads the object representations of the values in the range
+ * straight from the stream buffer, as written by
+ * <tt>ostream::write()</tt>, until the range is full or the stream
+ * ends. No formatting or whitespace skipping is done.
+ * 
+ * \param   r   The contiguous range of trivially copyable values to
+ *              write values to.
+ * 
+ * \tparam  Range     The range type to read into.
+ * 
+ * \return  A range input operation object for the given range, with the desired
+ *          behaviour.
+ */
+template <typename Range>
+auto read_binary(Range& r) ->
+  rangeio_detail::range_input_operation<Range, rangeio_detail::iterator_type_of<Range>, rangeio_detail::binary_overwrite_behaviour<Range>>
+{
+  return input(r, begin(r), rangeio_detail::binary_overwrite_behaviour<Range>{});
+}
+
+/** Binary back insert range input function.
+ * 
+ * Reads the object representations of up to \a n values straight
+ * from the stream buffer, as written by <tt>ostream::write()</tt>,
+ * and appends them to the range. No formatting or whitespace
+ * skipping is done.
+ * 
+ * \param   r   The contiguous range of trivially copyable values to
+ *              write values to, which must have <tt>resize()</tt>
+ *              and <tt>data()</tt> member functions.
+ * \param   n   The maximum number of values to read in a single
+ *              input operation.
+ * 
+ * \tparam  Range     The range type to read into.
+ * 
+ * \return  A range input operation object for the given range, with the desired
+ *          behaviour.
+ */
+template <typename Range>
+auto read_binary_n(Range& r, size_t n) ->
+  rangeio_detail::range_input_operation<Range, rangeio_detail::iterator_type_of<Range>, rangeio_detail::binary_back_insert_behaviour<Range>>
+{
+  return input(r, end(r), rangeio_detail::binary_back_insert_behaviour<Range>{n});
+}
+
+} // namespace std
+
+#endif // STD_RANGEIO_read_binary_
@@ -0,0 +1,203 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef STD_RANGEIO_read_lazy_
+#define STD_RANGEIO_read_lazy_
+
+#include <cstddef>
+#include <ios>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "input.hpp"
+
+namespace std {
+namespace rangeio_detail {
+
+/** Single pass range of the values in a stream, read one at a time as
+ * the range is iterated over.
+ * 
+ * Only one value is held at a time, so the memory used doesn't
+ * depend on the length of the stream. The formatting state of the
+ * stream when the range is created is restored before every value,
+ * just as for the other range input functions.
+ * 
+ * The caller's code runs between values, and may change the stream's
+ * locale, so each value is read with an input source of its own,
+ * which looks up the locale facets it needs afresh.
+ * 
+ * The range ends when a value can't be read. Like every other input
+ * range, iterating over it consumes it: all iterators refer to the
+ * same position.
+ * 
+ * \tparam T       The type of the values read.
+ * \tparam CharT   The character type of the stream.
+ * \tparam Traits  The character traits of the stream.
+ */
+template <typename T, typename CharT, typename Traits>
+struct lazy_input_range
+{
+  //! Iterator type for the range.
+  struct iterator
+  {
+    using iterator_category = input_iterator_tag;
+    using value_type = T;
+    using difference_type = ptrdiff_t;
+    using pointer = T const*;
+    using reference = T const&;
+    
+    //! Holds a copy of the current value for post-increment.
+    struct postfix_proxy
+    {
+      auto operator*() const -> T const&
+      {
+        return v_;
+      }
+      
+      T v_;
+    };
+    
+    auto operator*() const -> T const&
+    {
+      return r_->value_;
+    }
+    
+    auto operator->() const -> T const*
+    {
+      return addressof(r_->value_);
+    }
+    
+    auto operator++() -> iterator&
+    {
+      r_->read();
+      return *this;
+    }
+    
+    auto operator++(int) -> postfix_proxy
+    {
+      auto proxy = postfix_proxy{r_->value_};
+      r_->read();
+      return proxy;
+    }
+    
+    //! Whether this is the end iterator, or the range has ended.
+    auto at_end() const -> bool
+    {
+      return !r_ || !r_->good_;
+    }
+    
+    friend auto operator==(iterator const& a, iterator const& b) -> bool
+    {
+      return (a.at_end() == b.at_end()) && (a.at_end() || (a.r_ == b.r_));
+    }
+    
+    friend auto operator!=(iterator const& a, iterator const& b) -> bool
+    {
+      return !(a == b);
+    }
+    
+    lazy_input_range* r_;
+  };
+  
+  explicit lazy_input_range(basic_istream<CharT, Traits>& in) :
+    in_{in},
+    formatting_{in}
+  {}
+  
+  lazy_input_range(lazy_input_range const&) = default;
+  
+  auto operator=(lazy_input_range const&) -> lazy_input_range& = delete;
+  
+  /** Returns an iterator to the current value.
+   * 
+   * The first call reads the first value.
+   */
+  auto begin() -> iterator
+  {
+    if (!started_)
+    {
+      started_ = true;
+      read();
+    }
+    
+    return iterator{this};
+  }
+  
+  auto end() -> iterator
+  {
+    return iterator{nullptr};
+  }
+  
+  /** Reads the next value from the stream.
+   * 
+   * The tied stream is flushed once for every value, just as the
+   * extractors would, because the caller may write to it between
+   * values. When a value can't be read, the width of the stream is
+   * reset, as it is by every range input operation.
+   */
+  auto read() -> void
+  {
+    {
+      tie_flusher<CharT, Traits> const flusher{in_};
+      input_source<CharT, Traits> source{in_, formatting_};
+      good_ = source.extract(value_);
+    }
+    
+    if (good_)
+      ++count;
+    else
+      in_.width(0);
+  }
+  
+  basic_istream<CharT, Traits>& in_;
+  stream_formatting_saver<CharT, Traits> const formatting_;
+  T value_{};
+  bool started_ = false;
+  bool good_ = false;
+  
+  //! The number of values read so far.
+  size_t count = 0;
+};
+
+} // namespace rangeio_detail
+
+/** Lazy range input function.
+ * 
+ * Returns a single pass range of the values of type \a T in the
+ * stream, which reads them one at a time, as it is iterated over.
+ * It can be used in a range-based for loop, or as the source for
+ * <tt>write_all()</tt>, without ever holding more than one value.
+ * 
+ * \param   in  The stream to read from. It must outlive the range.
+ * 
+ * \tparam  T       The type of the values to read.
+ * \tparam  CharT   The character type of the stream.
+ * \tparam  Traits  The character traits of the stream.
+ * 
+ * \return  A range of the values in the stream.
+ */
+template <typename T, typename CharT, typename Traits>
+auto read_lazy(basic_istream<CharT, Traits>& in) ->
+  rangeio_detail::lazy_input_range<T, CharT, Traits>
+{
+  return rangeio_detail::lazy_input_range<T, CharT, Traits>{in};
+}
+
+} // namespace std
+
+#endif // STD_RANGEIO_read_lazy_
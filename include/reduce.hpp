@@ -0,0 +1,338 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef STD_RANGEIO_reduce_
+#define STD_RANGEIO_reduce_
+
+#include <ios>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include "input.hpp"
+
+namespace std {
+namespace rangeio_detail {
+
+//! Reduction operation that adds values to the result.
+struct sum_op
+{
+  template <typename Result, typename T>
+  auto operator()(Result r, T&& v) const -> Result
+  {
+    r += forward<T>(v);
+    return r;
+  }
+};
+
+//! Reduction operation that keeps the least value.
+struct min_op
+{
+  template <typename Result, typename T>
+  auto operator()(Result r, T&& v) const -> Result
+  {
+    if (v < r)
+      r = forward<T>(v);
+    
+    return r;
+  }
+};
+
+//! Reduction operation that keeps the greatest value.
+struct max_op
+{
+  template <typename Result, typename T>
+  auto operator()(Result r, T&& v) const -> Result
+  {
+    if (r < v)
+      r = forward<T>(v);
+    
+    return r;
+  }
+};
+
+//! Reduction operation that counts values.
+struct count_op
+{
+  template <typename Result, typename T>
+  auto operator()(Result r, T&&) const -> Result
+  {
+    ++r;
+    return r;
+  }
+};
+
+/** Reducing range input behaviour type.
+ * 
+ * Rather than a range, the "range" read into is the result of the
+ * reduction, which every value read is folded into as it is read.
+ * No values are kept.
+ * 
+ * \tparam T       The type of the values read from the stream.
+ * \tparam Result  The type of the result.
+ * \tparam Op      The reduction operation, called as
+ *                 <tt>op(move(result), move(value))</tt> , returning
+ *                 the new result.
+ */
+template <typename T, typename Result, typename Op>
+struct reduce_behaviour
+{
+  //! The type of the values read from the stream.
+  using value_type = T;
+  
+  /** Constructs a reduce behaviour object.
+   * 
+   * \param   op    The reduction operation.
+   * \param   seed  Whether the first value read in each read
+   *                operation replaces the result, rather than being
+   *                folded into it.
+   */
+  reduce_behaviour(Op op, bool seed) :
+    v_{},
+    op_(move(op)),
+    seed_{seed}
+  {}
+  
+  /** Prepares the input operation.
+   * 
+   * \param  r   The result.
+   * \param  i   Unused.
+   * 
+   * \return   A tuple containing:
+   *             - \c true .
+   *             - the address of \a r .
+   */
+  auto prepare(Result& r, Result*) ->
+    tuple<bool, Result*>
+  {
+    seeded_ = !seed_;
+    
+    return make_tuple(true, addressof(r));
+  }
+  
+  /** Reads a single value from the stream and folds it into the
+   * result.
+   * 
+   * \param  in      The stream being read.
+   * \param  r       The result.
+   * \param  i       The address of \a r .
+   * \param  source  The input source to read the value with.
+   * 
+   * \tparam CharT   The character type of the stream being read.
+   * \tparam Traits  The character traits of the stream being read.
+   * 
+   * \return   A tuple containing:
+   *             - \c true if input succeeded, \c false otherwise.
+   *             - \a i .
+   *             - \c true if input succeeded, \c false otherwise.
+   *             - \c true if input succeeded, \c false otherwise.
+   */
+  template <typename CharT, typename Traits>
+  auto read(basic_istream<CharT, Traits>& in, Result& r, Result* i, input_source<CharT, Traits>& source) ->
+    tuple<bool, Result*, bool, bool>
+  {
+    auto const result = read_bulk(in, r, i, source, 1);
+    
+    return make_tuple(get<0>(result), get<1>(result), get<2>(result) != 0, get<3>(result) != 0);
+  }
+  
+  /** Reads several values from the stream and folds them into the
+   * result.
+   * 
+   * \param  in      Unused.
+   * \param  r       The result.
+   * \param  i       The address of \a r .
+   * \param  source  The input source to read the values with.
+   * \param  max     The maximum number of values to read.
+   * 
+   * \tparam CharT   The character type of the stream being read.
+   * \tparam Traits  The character traits of the stream being read.
+   * 
+   * \return   A tuple containing:
+   *             - \c true if \a max values were read, \c false
+   *               otherwise.
+   *             - \a i .
+   *             - the number of values read.
+   *             - the number of values read.
+   */
+  template <typename CharT, typename Traits>
+  auto read_bulk(basic_istream<CharT, Traits>&, Result& r, Result* i, input_source<CharT, Traits>& source, size_t max) ->
+    tuple<bool, Result*, size_t, size_t>
+  {
+    auto n = size_t{0};
+    
+    try
+    {
+      for (; (n != max) && source.extract(v_); ++n)
+      {
+        if (seeded_)
+        {
+          r = op_(move(r), move(v_));
+        }
+        else
+        {
+          r = move(v_);
+          seeded_ = true;
+        }
+      }
+    }
+    catch (...)
+    {
+      progress_ = make_tuple(i, n, n);
+      throw;
+    }
+    
+    return make_tuple(n == max, i, n, n);
+  }
+  
+  /** Gets how far the last call to read_bulk() got before it threw.
+   * 
+   * \return   A tuple containing:
+   *             - the value that \c next should be set to.
+   *             - the number of values read.
+   *             - the number of values read.
+   */
+  auto progress_after_exception() ->
+    tuple<Result*, size_t, size_t>
+  {
+    return progress_;
+  }
+  
+  //! An instance of the value type, to use as a buffer for reading into.
+  T v_;
+  
+  //! The reduction operation.
+  Op op_;
+  
+  //! Whether the first value read replaces the result.
+  bool const seed_ = false;
+  
+  //! Whether the result has had a value folded into it in the
+  //! current read operation, or doesn't need one.
+  bool seeded_ = true;
+  
+  //! How far the last call to read_bulk() got, if it threw.
+  tuple<Result*, size_t, size_t> progress_;
+};
+
+template <typename T, typename Result, typename Op>
+using reduce_operation = range_input_operation<Result, Result*, reduce_behaviour<T, Result, Op>>;
+
+} // namespace rangeio_detail
+
+/** Folding range input function.
+ * 
+ * Reads values of type \a T until the stream fails, folding each one
+ * into \a r as it is read, with <tt>r = op(move(r), move(v))</tt> .
+ * No container is needed: only one value is held at a time. The
+ * \c count of the returned object is the number of values folded
+ * into \a r .
+ * 
+ * \param   r   The result, which holds the initial value.
+ * \param   op  The fold operation.
+ * 
+ * \tparam  T       The type of the values to read.
+ * \tparam  Result  The type of the result.
+ * \tparam  Op      The type of the fold operation.
+ * 
+ * \return  A range input operation object with the desired behaviour.
+ */
+template <typename T, typename Result, typename Op>
+auto fold(Result& r, Op op) ->
+  rangeio_detail::reduce_operation<T, Result, Op>
+{
+  return input(r, addressof(r), rangeio_detail::reduce_behaviour<T, Result, Op>{move(op), false});
+}
+
+/** Summing range input function.
+ * 
+ * Adds every value of type \a T read to \a r .
+ * 
+ * \param   r   The sum, which holds the initial value.
+ * 
+ * \tparam  T       The type of the values to read.
+ * \tparam  Result  The type of the sum.
+ * 
+ * \return  A range input operation object with the desired behaviour.
+ */
+template <typename T, typename Result>
+auto sum_of(Result& r) ->
+  rangeio_detail::reduce_operation<T, Result, rangeio_detail::sum_op>
+{
+  return input(r, addressof(r), rangeio_detail::reduce_behaviour<T, Result, rangeio_detail::sum_op>{{}, false});
+}
+
+/** Minimum range input function.
+ * 
+ * Sets \a r to the least value of type \a T read. If no values are
+ * read, \a r is left as it was.
+ * 
+ * \param   r   The minimum.
+ * 
+ * \tparam  T       The type of the values to read.
+ * \tparam  Result  The type of the minimum.
+ * 
+ * \return  A range input operation object with the desired behaviour.
+ */
+template <typename T, typename Result>
+auto min_of(Result& r) ->
+  rangeio_detail::reduce_operation<T, Result, rangeio_detail::min_op>
+{
+  return input(r, addressof(r), rangeio_detail::reduce_behaviour<T, Result, rangeio_detail::min_op>{{}, true});
+}
+
+/** Maximum range input function.
+ * 
+ * Sets \a r to the greatest value of type \a T read. If no values
+ * are read, \a r is left as it was.
+ * 
+ * \param   r   The maximum.
+ * 
+ * \tparam  T       The type of the values to read.
+ * \tparam  Result  The type of the maximum.
+ * 
+ * \return  A range input operation object with the desired behaviour.
+ */
+template <typename T, typename Result>
+auto max_of(Result& r) ->
+  rangeio_detail::reduce_operation<T, Result, rangeio_detail::max_op>
+{
+  return input(r, addressof(r), rangeio_detail::reduce_behaviour<T, Result, rangeio_detail::max_op>{{}, true});
+}
+
+/** Counting range input function.
+ * 
+ * Adds the number of values of type \a T read to \a r . Unlike
+ * <tt>discard()</tt>, every value is read in full, so only valid
+ * values are counted.
+ * 
+ * \param   r   The count, which holds the initial value.
+ * 
+ * \tparam  T       The type of the values to read.
+ * \tparam  Result  The type of the count.
+ * 
+ * \return  A range input operation object with the desired behaviour.
+ */
+template <typename T, typename Result>
+auto count_of(Result& r) ->
+  rangeio_detail::reduce_operation<T, Result, rangeio_detail::count_op>
+{
+  return input(r, addressof(r), rangeio_detail::reduce_behaviour<T, Result, rangeio_detail::count_op>{{}, false});
+}
+
+} // namespace std
+
+#endif // STD_RANGEIO_reduce_
@@ -17,10 +17,30 @@
 #define STD_RANGEIO_stream_formatting_saver_
 
 #include <iosfwd>
+#include <string>
+#include <type_traits>
 
 namespace std {
 namespace rangeio_detail {
 
+/* 
+ * Trait for types whose standard inserters and extractors never change the
+ * formatting state of the stream, other than resetting the width to zero:
+ * arithmetic, character, object pointer and string types. Function pointers
+ * are not included, because manipulators like std::hex are function pointers,
+ * and changing the formatting state is exactly what they do.
+ */
+template <typename T>
+struct has_standard_formatting :
+  integral_constant<bool, is_arithmetic<T>::value ||
+    (is_pointer<T>::value && !is_function<typename remove_pointer<T>::type>::value)>
+{};
+
+template <typename CharT, typename Traits, typename Allocator>
+struct has_standard_formatting<basic_string<CharT, Traits, Allocator>> :
+  true_type
+{};
+
 /* 
  * This is a helper class that stores the formatting state of a stream, and
  * restores that state on demand. It is used to keep the formatting consistent
@@ -34,7 +54,8 @@ struct stream_formatting_saver
     flags_{s.flags()},
     width_{s.width()},
     precision_{s.precision()},
-    fill_{s.fill()}
+    fill_{s.fill()},
+    restore_width_{width_ != 0}
   {}
   
   void restore() const
@@ -45,11 +66,35 @@ struct stream_formatting_saver
     stream_.width(width_);
   }
   
+  /* 
+   * Restores only the formatting state that inserting or extracting a value
+   * of type T can have changed. For types with standard formatting, that is
+   * just the width - and only if it wasn't zero to begin with. Values of any
+   * other type get a full restore().
+   */
+  template <typename T>
+  void restore_for() const
+  {
+    restore_for(has_standard_formatting<T>{});
+  }
+  
+  void restore_for(true_type) const
+  {
+    if (restore_width_)
+      stream_.width(width_);
+  }
+  
+  void restore_for(false_type) const
+  {
+    restore();
+  }
+  
   basic_ios<CharT, Traits>& stream_;
   typename basic_ios<CharT, Traits>::fmtflags const flags_;
   streamsize const width_;
   streamsize const precision_;
   CharT const fill_;
+  bool const restore_width_;
 };
 
 } // namespace rangeio_detail
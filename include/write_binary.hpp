@@ -0,0 +1,212 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef STD_RANGEIO_write_binary_
+#define STD_RANGEIO_write_binary_
+
+#include <cstring>
+#include <initializer_list>
+#include <ios>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "output.hpp"
+
+namespace std {
+namespace rangeio_detail {
+
+//! The number of stream characters staged at a time when writing
+//! ranges that aren't contiguous.
+constexpr size_t binary_stage_size = 8192;
+
+/** Binary range output object, returned by <tt>write_binary()</tt>.
+ * 
+ * After it is written to a stream, \c count is the number of values
+ * whose object representations were written completely, and \c next
+ * refers to the first value that wasn't.
+ * 
+ * \tparam Range     The range type (possibly a reference).
+ * \tparam Iterator  The iterator type of the range.
+ */
+template <typename Range, typename Iterator = decltype(begin(declval<Range&>()))>
+struct binary_range_writer
+{
+  explicit binary_range_writer(Range&& r) :
+    range_{forward<Range>(r)}
+  {
+    next = begin(range_);
+  }
+  
+  Range range_;
+  size_t count = 0;
+  Iterator next;
+};
+
+/** Writes the object representations of a contiguous range with a
+ * single call to <tt>sputn()</tt>.
+ * 
+ * \param  out  The stream to write to.
+ * \param  p    The binary range writer.
+ * 
+ * \return   \c true if everything was written.
+ */
+template <typename Range, typename Iterator, typename CharT, typename Traits>
+auto write_representations(basic_ostream<CharT, Traits>& out, binary_range_writer<Range, Iterator>& p, true_type) -> bool
+{
+  using value_type = value_type_of<Range>;
+  constexpr auto chars_per_value = sizeof(value_type) / sizeof(CharT);
+  
+  auto const n = distance(p.next, end(p.range_));
+  if (!n)
+    return true;
+  
+  auto const wanted = static_cast<streamsize>(static_cast<size_t>(n) * chars_per_value);
+  auto const written = out.rdbuf()->sputn(reinterpret_cast<CharT const*>(addressof(*p.next)), wanted);
+  
+  p.count = static_cast<size_t>(written) / chars_per_value;
+  advance(p.next, p.count);
+  
+  return written == wanted;
+}
+
+/** Writes the object representations of a range that isn't
+ * contiguous, copying them into a buffer a block at a time and
+ * writing each block with a single call to <tt>sputn()</tt>.
+ * 
+ * \param  out  The stream to write to.
+ * \param  p    The binary range writer.
+ * 
+ * \return   \c true if everything was written.
+ */
+template <typename Range, typename Iterator, typename CharT, typename Traits>
+auto write_representations(basic_ostream<CharT, Traits>& out, binary_range_writer<Range, Iterator>& p, false_type) -> bool
+{
+  using value_type = value_type_of<Range>;
+  constexpr auto chars_per_value = sizeof(value_type) / sizeof(CharT);
+  constexpr auto values_per_block = (binary_stage_size / chars_per_value) ? (binary_stage_size / chars_per_value) : 1;
+  
+  CharT block[values_per_block * chars_per_value];
+  
+  auto const last = end(p.range_);
+  while (p.next != last)
+  {
+    auto values = size_t{0};
+    for (auto i = p.next; (i != last) && (values != values_per_block); ++i, ++values)
+    {
+      // Copied first, in case the iterator only gives a proxy.
+      auto const v = value_type(*i);
+      memcpy(block + (values * chars_per_value), addressof(v), sizeof(value_type));
+    }
+    
+    auto const wanted = static_cast<streamsize>(values * chars_per_value);
+    auto const written = out.rdbuf()->sputn(block, wanted);
+    auto const n = static_cast<size_t>(written) / chars_per_value;
+    
+    p.count += n;
+    advance(p.next, n);
+    
+    if (written != wanted)
+      return false;
+  }
+  
+  return true;
+}
+
+/** Writes the object representations of the values in a range.
+ * 
+ * This is unformatted output, just like <tt>ostream::write()</tt>:
+ * the width and formatting flags of the stream aren't used, and if
+ * not everything can be written, \c badbit is set. \c count and
+ * \c next are only advanced past values written in full.
+ * 
+ * \param  out  The stream to write to.
+ * \param  p    The binary range writer.
+ * 
+ * \return   \a out .
+ */
+template <typename Range, typename Iterator, typename CharT, typename Traits>
+auto operator<<(basic_ostream<CharT, Traits>& out, binary_range_writer<Range, Iterator>& p) ->
+  basic_ostream<CharT, Traits>&
+{
+  using value_type = value_type_of<Range>;
+  
+  static_assert(is_trivially_copyable<value_type>::value, "binary output needs trivially copyable values");
+  static_assert((sizeof(value_type) % sizeof(CharT)) == 0, "binary output needs values made of whole stream characters");
+  
+  p.count = 0;
+  p.next = begin(p.range_);
+  
+  typename basic_ostream<CharT, Traits>::sentry const sentry{out};
+  if (sentry)
+  {
+    try
+    {
+      if (!write_representations(out, p, is_contiguous_range<typename remove_reference<Range>::type>{}))
+        out.setstate(ios_base::badbit);
+    }
+    catch (...)
+    {
+      handle_output_exception(out);
+    }
+  }
+  
+  return out;
+}
+
+template <typename Range, typename Iterator, typename CharT, typename Traits>
+auto operator<<(basic_ostream<CharT, Traits>& out, binary_range_writer<Range, Iterator>&& p) ->
+  basic_ostream<CharT, Traits>&
+{
+  return out << p;
+}
+
+} // namespace rangeio_detail
+
+/** Binary range output function.
+ * 
+ * Writes the object representations of the values in the range
+ * straight to the stream buffer, as <tt>ostream::write()</tt>
+ * would, so they can be read back with <tt>read_binary()</tt>.
+ * Contiguous ranges are written with a single call to
+ * <tt>sputn()</tt>; other ranges are copied into a buffer and
+ * written a block at a time.
+ * 
+ * \param   r   The range of trivially copyable values to write.
+ * 
+ * \tparam  Range     The range type to write.
+ * 
+ * \return  A range output object for the given range.
+ */
+template <typename Range>
+auto write_binary(Range&& r) ->
+  rangeio_detail::binary_range_writer<Range&&>
+{
+  return rangeio_detail::binary_range_writer<Range&&>{forward<Range>(r)};
+}
+
+template <typename T>
+auto write_binary(std::initializer_list<T>&& r) ->
+  rangeio_detail::binary_range_writer<std::initializer_list<T>&&>
+{
+  return rangeio_detail::binary_range_writer<std::initializer_list<T>&&>{forward<std::initializer_list<T>>(r)};
+}
+
+} // namespace std
+
+#endif // STD_RANGEIO_write_binary_
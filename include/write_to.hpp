@@ -0,0 +1,536 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STD_RANGEIO_write_to_
+#define STD_RANGEIO_write_to_
+
+#include <algorithm>
+#include <ios>
+#include <iterator>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "output.hpp"
+
+namespace std {
+namespace rangeio_detail {
+
+/** Output target that appends to a container.
+ * 
+ * \tparam Container  The container type.
+ */
+template <typename Container>
+struct container_target
+{
+  template <typename CharT>
+  void append(CharT const* s, streamsize n)
+  {
+    c_.insert(c_.end(), s, s + n);
+  }
+  
+  void reserve(streamsize n)
+  {
+    c_.reserve(c_.size() + static_cast<typename Container::size_type>(n));
+  }
+  
+  Container& c_;
+};
+
+/** Output target that writes through an output iterator.
+ * 
+ * \tparam OutputIterator  The output iterator type.
+ */
+template <typename OutputIterator>
+struct iterator_target
+{
+  template <typename CharT>
+  void append(CharT const* s, streamsize n)
+  {
+    i_ = copy(s, s + n, i_);
+  }
+  
+  OutputIterator i_;
+};
+
+/** Stream buffer that writes to an output target.
+ * 
+ * Output is collected in a small put area, and handed to the
+ * target whenever that fills up, or the stream buffer is synced.
+ * Large writes go straight to the target. Writing never fails;
+ * any exception thrown by the target is propagated.
+ * 
+ * \tparam CharT   The character type.
+ * \tparam Traits  The character traits.
+ * \tparam Target  The output target type.
+ */
+template <typename CharT, typename Traits, typename Target>
+struct target_streambuf :
+  basic_streambuf<CharT, Traits>
+{
+  using int_type = typename Traits::int_type;
+  
+  explicit target_streambuf(Target& t) :
+    target_(t)
+  {
+    this->setp(buffer_, buffer_ + buffer_size);
+  }
+  
+  auto overflow(int_type c) -> int_type override
+  {
+    sync();
+    
+    if (!Traits::eq_int_type(c, Traits::eof()))
+    {
+      Traits::assign(*this->pptr(), Traits::to_char_type(c));
+      this->pbump(1);
+    }
+    
+    return Traits::not_eof(c);
+  }
+  
+  auto xsputn(CharT const* s, streamsize n) -> streamsize override
+  {
+    if (n > (this->epptr() - this->pptr()))
+    {
+      sync();
+      
+      if (n >= buffer_size)
+      {
+        target_.append(s, n);
+        return n;
+      }
+    }
+    
+    Traits::copy(this->pptr(), s, static_cast<size_t>(n));
+    this->pbump(static_cast<int>(n));
+    
+    return n;
+  }
+  
+  auto sync() -> int override
+  {
+    auto const n = this->pptr() - this->pbase();
+    
+    this->setp(buffer_, buffer_ + buffer_size);
+    target_.append(static_cast<CharT const*>(buffer_), n);
+    
+    return 0;
+  }
+  
+  static constexpr streamsize buffer_size = 256;
+  
+  Target& target_;
+  CharT buffer_[buffer_size];
+};
+
+/** Output sink that only counts the characters written to it.
+ * 
+ * \tparam CharT   The character type.
+ * \tparam Traits  The character traits.
+ */
+template <typename CharT, typename Traits>
+struct counting_sink
+{
+  using traits_type = Traits;
+  
+  auto put(CharT const*, streamsize n) -> bool
+  {
+    n_ += n;
+    return true;
+  }
+  
+  auto put(CharT) -> bool
+  {
+    ++n_;
+    return true;
+  }
+  
+  auto fill(CharT, streamsize n) -> bool
+  {
+    n_ += n;
+    return true;
+  }
+  
+  streamsize n_ = 0;
+};
+
+/** Computes the length of a directly written value.
+ * 
+ * Integers are measured by counting their digits, anything else by
+ * formatting it to a counting sink.
+ * 
+ * \param  v   The value.
+ * \param  f   The formatting state.
+ * 
+ * \return   The number of characters the value is written as.
+ */
+template <typename T, typename CharT, typename Traits>
+auto formatted_length(T const& v, output_format<CharT> const& f, false_type) -> streamsize
+{
+  auto sink = counting_sink<CharT, Traits>{};
+  direct_writer<T, CharT>::write(sink, v, f);
+  
+  return sink.n_;
+}
+
+template <typename T, typename CharT, typename Traits>
+auto formatted_length(T const& v, output_format<CharT> const& f, true_type) -> streamsize
+{
+  return direct_writer<T, CharT>::length(v, f);
+}
+
+/** Computes the length of the output of a sequence of directly
+ * written values.
+ * 
+ * \param  first  The first value.
+ * \param  last   One past the last value.
+ * \param  f      The formatting state.
+ * \param  delim  The delimiter.
+ * 
+ * \return   The number of characters the sequence is written as.
+ */
+template <typename Iterator, typename Sentinel, typename CharT, typename Traits, typename Delim>
+auto measure_direct(Iterator first, Sentinel last, output_format<CharT> const& f, Delim const& delim) -> streamsize
+{
+  using value_type = typename iterator_traits<Iterator>::value_type;
+  using is_integer = integral_constant<bool, is_integral<value_type>::value && !is_character<value_type>::value && !is_same<value_type, bool>::value>;
+  
+  auto delimiter = counting_sink<CharT, Traits>{};
+  delim.write(delimiter);
+  
+  auto n = streamsize{0};
+  
+  for (auto i = first; i != last; ++i)
+  {
+    if (i != first)
+      n += delimiter.n_;
+    
+    n += formatted_length<value_type, CharT, Traits>(*i, f, is_integer{});
+  }
+  
+  return n;
+}
+
+/** Computes the length of the output of a range writer directly, if
+ * possible.
+ * 
+ * \param  out  The stream the range writer will be written to.
+ * \param  w    The range writer.
+ * 
+ * \return   The length of the output, or -1 if it can't be computed
+ *           directly.
+ */
+template <typename Range, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto measure_direct(basic_ostream<CharT, Traits>& out, range_writer<Range, Iterator, Parallel>& w, true_type) -> streamsize
+{
+  if (!direct_writer<value_type_of<Range>, CharT>::usable(out))
+    return -1;
+  
+  auto const formatting = stream_formatting_saver<CharT, Traits>{out};
+  
+  return measure_direct<iterator_type_of<Range>, iterator_type_of<Range>, CharT, Traits>(
+    begin(w.range_), end(w.range_), output_format_of(formatting, w.shortest_), no_delimiter{});
+}
+
+template <typename Range, typename Delim, typename Iterator, typename Parallel, typename CharT, typename Traits>
+auto measure_direct(basic_ostream<CharT, Traits>& out, range_writer_delimited<Range, Delim, Iterator, Parallel>& w, true_type) -> streamsize
+{
+  auto const rendered = rendered_delimiter_of<Delim, CharT, Traits>{out, w.delim_};
+  
+  if (!direct_writer<value_type_of<Range>, CharT>::usable(out) || !rendered.usable())
+    return -1;
+  
+  auto const formatting = stream_formatting_saver<CharT, Traits>{out};
+  
+  return measure_direct<iterator_type_of<Range>, iterator_type_of<Range>, CharT, Traits>(
+    begin(w.range_), end(w.range_), output_format_of(formatting, w.shortest_), rendered);
+}
+
+/** Helper template to detect range writers that can be measured directly.
+ * 
+ * \tparam Writer  The range writer type.
+ * \tparam CharT   The character type.
+ * \tparam Traits  The character traits.
+ */
+template <typename Writer, typename CharT, typename Traits>
+struct is_directly_measurable :
+  false_type
+{};
+
+template <typename Range, typename Iterator, typename Parallel, typename CharT, typename Traits>
+struct is_directly_measurable<range_writer<Range, Iterator, Parallel>, CharT, Traits> :
+  integral_constant<bool, direct_writer<value_type_of<Range>, CharT>::value>
+{};
+
+template <typename Range, typename Delim, typename Iterator, typename Parallel, typename CharT, typename Traits>
+struct is_directly_measurable<range_writer_delimited<Range, Delim, Iterator, Parallel>, CharT, Traits> :
+  integral_constant<bool, direct_writer<value_type_of<Range>, CharT>::value && rendered_delimiter_of<Delim, CharT, Traits>::value>
+{};
+
+/** Helper template to detect range writers whose range can be traversed
+ * more than once.
+ * 
+ * \tparam Writer  The range writer type.
+ */
+template <typename Writer>
+struct is_multipass_writer :
+  false_type
+{};
+
+template <typename Range, typename Iterator, typename Parallel>
+struct is_multipass_writer<range_writer<Range, Iterator, Parallel>> :
+  is_base_of<forward_iterator_tag, typename iterator_traits<Iterator>::iterator_category>
+{};
+
+template <typename Range, typename Delim, typename Iterator, typename Parallel>
+struct is_multipass_writer<range_writer_delimited<Range, Delim, Iterator, Parallel>> :
+  is_base_of<forward_iterator_tag, typename iterator_traits<Iterator>::iterator_category>
+{};
+
+/** Reserves space in an output target for the output of a range writer.
+ * 
+ * The lengths of the elements and delimiters are computed without
+ * writing anything - integers aren't even formatted. If the stream's
+ * formatting state means they can't be written directly after all,
+ * nothing is reserved.
+ * 
+ * \param  out  The stream the range writer will be written to.
+ * \param  t    The output target.
+ * \param  w    The range writer.
+ */
+template <typename CharT, typename Traits, typename Target, typename Writer>
+auto reserve_for(basic_ostream<CharT, Traits>& out, Target& t, Writer& w, true_type) -> void
+{
+  auto const n = measure_direct(out, w, true_type{});
+  if (n >= 0)
+    t.reserve(n);
+}
+
+/** Does nothing; a range that can only be traversed once, or whose
+ * elements or delimiter have to go through their inserters, isn't
+ * measured in advance.
+ */
+template <typename CharT, typename Traits, typename Target, typename Writer>
+auto reserve_for(basic_ostream<CharT, Traits>&, Target&, Writer&, false_type) -> void
+{}
+
+/** Writes the output of a range writer to an output target.
+ * 
+ * The range writer is written to a stream with the default
+ * formatting state - just like a newly constructed string stream -
+ * whose stream buffer writes straight to the target, so there is no
+ * intermediate string. Errors are reported with exceptions; the
+ * output written before the error is still flushed to the target.
+ * 
+ * \param  t   The output target.
+ * \param  w   The range writer.
+ * 
+ * \tparam CharT   The character type to write.
+ * \tparam Traits  The character traits.
+ */
+template <typename CharT, typename Traits, typename Target, typename Writer>
+auto write_to_target(Target& t, Writer& w) -> void
+{
+  target_streambuf<CharT, Traits, Target> buf{t};
+  
+  basic_ostream<CharT, Traits> out{&buf};
+  out.exceptions(ios_base::badbit);
+  
+  try
+  {
+    out << w;
+  }
+  catch (...)
+  {
+    buf.pubsync();
+    throw;
+  }
+  
+  buf.pubsync();
+}
+
+/** Writes the output of a range writer to an output target, after
+ * reserving exactly the space needed for it.
+ * 
+ * The length of the output is computed first, and reserved in the
+ * target in one go, then the range writer is written to the target.
+ * That is only done if the range can be traversed more than once,
+ * and its elements and delimiter can be measured directly: anything
+ * else is written just as by write_to_target(), so inserters - which
+ * may have side effects - are only ever called once per value.
+ * 
+ * \param  t   The output target.
+ * \param  w   The range writer.
+ * 
+ * \tparam CharT   The character type to write.
+ * \tparam Traits  The character traits.
+ */
+template <typename CharT, typename Traits, typename Target, typename Writer>
+auto write_to_target_exact(Target& t, Writer& w) -> void
+{
+  target_streambuf<CharT, Traits, Target> buf{t};
+  
+  basic_ostream<CharT, Traits> out{&buf};
+  out.exceptions(ios_base::badbit);
+  
+  using writer_type = typename decay<Writer>::type;
+  using measurable = integral_constant<bool, is_multipass_writer<writer_type>::value && is_directly_measurable<writer_type, CharT, Traits>::value>;
+  
+  reserve_for(out, t, w, measurable{});
+  
+  try
+  {
+    out << w;
+  }
+  catch (...)
+  {
+    buf.pubsync();
+    throw;
+  }
+  
+  buf.pubsync();
+}
+
+} // namespace rangeio_detail
+
+/** Tag type to request that the space for the output is reserved
+ * exactly, before writing it.
+ */
+struct exact_size_t
+{
+  explicit exact_size_t() = default;
+};
+
+constexpr exact_size_t exact_size{};
+
+/** Writes the output of a range writer to a string.
+ * 
+ * The output is appended to the string. It is exactly what writing
+ * \a w to a newly constructed string stream would produce.
+ * 
+ * \param  s   The string to append to.
+ * \param  w   The range writer - the result of a call to
+ *             <tt>write_all()</tt>.
+ * 
+ * \return  \a s .
+ */
+template <typename CharT, typename Traits, typename Allocator, typename Writer>
+auto write_to(basic_string<CharT, Traits, Allocator>& s, Writer&& w) ->
+  basic_string<CharT, Traits, Allocator>&
+{
+  auto target = rangeio_detail::container_target<basic_string<CharT, Traits, Allocator>>{s};
+  rangeio_detail::write_to_target<CharT, Traits>(target, w);
+  
+  return s;
+}
+
+/** Writes the output of a range writer to a vector of characters.
+ * 
+ * The output is appended to the vector. It is exactly what writing
+ * \a w to a newly constructed string stream would produce.
+ * 
+ * \param  v   The vector to append to.
+ * \param  w   The range writer - the result of a call to
+ *             <tt>write_all()</tt>.
+ * 
+ * \return  \a v .
+ */
+template <typename CharT, typename Allocator, typename Writer>
+auto write_to(vector<CharT, Allocator>& v, Writer&& w) ->
+  vector<CharT, Allocator>&
+{
+  auto target = rangeio_detail::container_target<vector<CharT, Allocator>>{v};
+  rangeio_detail::write_to_target<CharT, char_traits<CharT>>(target, w);
+  
+  return v;
+}
+
+/** Writes the output of a range writer to a string, reserving exactly
+ * the space needed first.
+ * 
+ * This makes two passes over the range: the first computes the
+ * exact length of the output (without formatting integers at all),
+ * which is then reserved in the string in one go, so the second pass
+ * that writes the output never reallocates. Ranges that can only be
+ * traversed once, or whose elements or delimiter can't be written
+ * directly, are written in a single pass, just as without
+ * \c exact_size .
+ * 
+ * \param  s   The string to append to.
+ * \param  w   The range writer - the result of a call to
+ *             <tt>write_all()</tt>.
+ * 
+ * \return  \a s .
+ */
+template <typename CharT, typename Traits, typename Allocator, typename Writer>
+auto write_to(exact_size_t, basic_string<CharT, Traits, Allocator>& s, Writer&& w) ->
+  basic_string<CharT, Traits, Allocator>&
+{
+  auto target = rangeio_detail::container_target<basic_string<CharT, Traits, Allocator>>{s};
+  rangeio_detail::write_to_target_exact<CharT, Traits>(target, w);
+  
+  return s;
+}
+
+/** Writes the output of a range writer to a vector of characters,
+ * reserving exactly the space needed first.
+ * 
+ * \param  v   The vector to append to.
+ * \param  w   The range writer - the result of a call to
+ *             <tt>write_all()</tt>.
+ * 
+ * \return  \a v .
+ */
+template <typename CharT, typename Allocator, typename Writer>
+auto write_to(exact_size_t, vector<CharT, Allocator>& v, Writer&& w) ->
+  vector<CharT, Allocator>&
+{
+  auto target = rangeio_detail::container_target<vector<CharT, Allocator>>{v};
+  rangeio_detail::write_to_target_exact<CharT, char_traits<CharT>>(target, w);
+  
+  return v;
+}
+
+/** Writes the output of a range writer through an output iterator.
+ * 
+ * The output is exactly what writing \a w to a newly constructed
+ * string stream would produce.
+ * 
+ * \param  i   The output iterator.
+ * \param  w   The range writer - the result of a call to
+ *             <tt>write_all()</tt>.
+ * 
+ * \tparam CharT   The character type to write.
+ * \tparam Traits  The character traits.
+ * 
+ * \return  The output iterator, past the last character written.
+ */
+template <typename CharT = char, typename Traits = char_traits<CharT>, typename OutputIterator, typename Writer>
+auto write_to(OutputIterator i, Writer&& w) ->
+  OutputIterator
+{
+  auto target = rangeio_detail::iterator_target<OutputIterator>{i};
+  rangeio_detail::write_to_target<CharT, Traits>(target, w);
+  
+  return target.i_;
+}
+
+} // namespace std
+
+#endif  // STD_RANGEIO_write_to_
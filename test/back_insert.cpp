@@ -21,16 +21,124 @@
  * These tests are not meant to be exhaustive, merely illustrative.
  */
 
+#include <algorithm>
+#include <cstddef>
+#include <ios>
 #include <iterator>
 #include <list>
 #include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <rangeio>
 
 #include "gtest/gtest.h"
 
+namespace {
+
+/* 
+ * A stream buffer that reads from a string, but makes only a few characters
+ * available at a time, so that values straddle the ends of its get area.
+ */
+struct chunked_buffer : std::streambuf
+{
+  chunked_buffer(std::string s, std::size_t n) :
+    s_{std::move(s)},
+    n_{n}
+  {
+    setg(&s_[0], &s_[0], &s_[0]);
+  }
+  
+  auto underflow() -> int_type override
+  {
+    auto const end = &s_[0] + s_.size();
+    if (egptr() == end)
+      return traits_type::eof();
+    
+    auto const n = std::min<std::ptrdiff_t>(static_cast<std::ptrdiff_t>(n_), end - egptr());
+    setg(egptr(), egptr(), egptr() + n);
+    
+    return traits_type::to_int_type(*gptr());
+  }
+  
+  std::string s_;
+  std::size_t n_;
+};
+
+/* 
+ * Reads values of type T from a stream one by one with their extractors,
+ * until the stream fails. This is what back_insert() should be equivalent to.
+ */
+template <typename T>
+auto read_one_by_one(std::istream& in) -> std::vector<T>
+{
+  auto r = std::vector<T>{};
+  
+  for (auto v = T{}; in >> v; )
+    r.push_back(v);
+  
+  return r;
+}
+
+/* 
+ * Checks that back_insert() reads exactly the same values as the extractors
+ * from the input s, leaving the stream in the same state.
+ */
+template <typename T>
+auto expect_same_as_extractors(std::string const& s, std::ios_base::fmtflags flags = std::ios_base::skipws | std::ios_base::dec) -> void
+{
+  for (auto n : { std::size_t{0}, std::size_t{1}, std::size_t{7} })
+  {
+    auto const buffered = (n == 0);
+    
+    chunked_buffer expected_buf{s, n ? n : s.size()};
+    std::istream expected{&expected_buf};
+    expected.flags(flags);
+    
+    chunked_buffer actual_buf{s, n ? n : s.size()};
+    std::istream actual{&actual_buf};
+    actual.flags(flags);
+    
+    auto const v = read_one_by_one<T>(expected);
+    
+    auto r = std::vector<T>{};
+    EXPECT_FALSE(actual >> std::back_insert(r));
+    
+    EXPECT_EQ(v, r) << "input: " << s << ", buffered: " << buffered;
+    EXPECT_EQ(expected.rdstate(), actual.rdstate()) << "input: " << s;
+    
+    expected.clear();
+    actual.clear();
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>{expected}, {}), std::string(std::istreambuf_iterator<char>{actual}, {})) << "input: " << s;
+  }
+}
+
+/* 
+ * A stream buffer that throws instead of reporting the end of its contents.
+ */
+struct throwing_buffer : std::stringbuf
+{
+  explicit throwing_buffer(std::string const& s) :
+    std::stringbuf{s}
+  {}
+  
+  auto underflow() -> int_type override
+  {
+    auto const c = std::stringbuf::underflow();
+    
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+      throw std::runtime_error{"end of input"};
+    
+    return c;
+  }
+};
+
+} // anonymous namespace
+
 /* Test: Verify the types associated with back_insert() are correct.
  * 
  * The return value of back_insert() should be an object with a size_t member
@@ -135,6 +243,29 @@ TEST(BackInsert, ErrorChecking)
   }
 }
 
+/* Test: Error checking when the stream throws on badbit.
+ * 
+ * The values read before the exception should be in the range, and counted in
+ * count and stored.
+ */
+TEST(BackInsert, ExceptionsErrorChecking)
+{
+  auto r = std::vector<int>{ 0 };
+  
+  throwing_buffer sb{"1 2 3 4 5"};
+  std::istream in{&sb};
+  in.exceptions(std::ios_base::badbit);
+  
+  auto p = std::back_insert(r);
+  
+  EXPECT_ANY_THROW(in >> p);
+  EXPECT_TRUE(in.bad());
+  EXPECT_EQ((std::vector<int>{ 0, 1, 2, 3, 4 }), r);
+  EXPECT_EQ(std::size_t{4}, p.count);
+  EXPECT_EQ(std::size_t{4}, p.stored);
+  EXPECT_TRUE(r.end() == p.next);
+}
+
 /* Test: Formatting when using back_insert().
  * 
  * Whatever the formatting state at the beginning of the input of a streamed
@@ -237,3 +368,212 @@ TEST(BackInsertN, Input)
     EXPECT_EQ(-.1, r.at(3));
   }
 }
+
+/* Test: Integer input using back_insert().
+ * 
+ * Integers are parsed straight out of the stream buffer where possible, but
+ * the values read, the characters consumed and the stream state must be
+ * exactly the same as with the extractors - including for numbers split
+ * across refills of the stream buffer, signs, out of range values and
+ * non-decimal input.
+ */
+TEST(BackInsert, Integers)
+{
+  auto many = std::string{};
+  for (auto n = 0L; n < 2000; ++n)
+    many += std::to_string((n % 2) ? n * 7919L : -n * 104729L) + ((n % 5) ? " " : "   \n\t ");
+  
+  expect_same_as_extractors<long>(many);
+  expect_same_as_extractors<int>(many);
+  expect_same_as_extractors<long long>(many + "x");
+  expect_same_as_extractors<unsigned>("1 22 333 4444 55555");
+  
+  expect_same_as_extractors<int>("1 +2 -3 0004 -0 5x 6");
+  expect_same_as_extractors<long>("1 2 99999999999999999999999 4");
+  expect_same_as_extractors<long>("1 2 -99999999999999999999999 4");
+  expect_same_as_extractors<short>("1 2 70000 4");
+  expect_same_as_extractors<unsigned>("5 -1 7 -");
+  expect_same_as_extractors<unsigned long long>("18446744073709551615 18446744073709551616 1");
+  expect_same_as_extractors<int>("- 1");
+  expect_same_as_extractors<int>("");
+  expect_same_as_extractors<int>("ff 10 0x1f z", std::ios_base::skipws | std::ios_base::hex);
+  expect_same_as_extractors<int>("010 0x10 10 9", std::ios_base::skipws);
+  expect_same_as_extractors<int>("1 2 3", std::ios_base::dec);
+}
+
+/* Test: Floating point input using back_insert().
+ * 
+ * Floats and doubles are parsed straight out of the stream buffer where
+ * possible, but the values read, the characters consumed and the stream
+ * state must be exactly the same as with the extractors - including for
+ * values that are hard to round correctly, malformed exponents, and values
+ * out of range.
+ */
+TEST(BackInsert, FloatingPoint)
+{
+  auto many = std::string{};
+  for (auto n = 1; n < 2000; ++n)
+  {
+    std::ostringstream out;
+    out.precision(n % 19);
+    out << ((n % 3) ? 1.0 / n : -n * 12345.6789e-7) << ((n % 4) ? " " : "e+2  ") << (n * 0.1) << 'E' << (n % 40 - 20) << '\n';
+    many += out.str();
+  }
+  
+  expect_same_as_extractors<double>(many);
+  expect_same_as_extractors<float>(many);
+  
+  for (auto s : {
+      "0.1 2.2250738585072011e-308 9007199254740993 1.7976931348623157e308 4.9e-324 x",
+      "-.5 .5 5. 00.25 1.5.5 1e5.5 -0 x",
+      "1.5e3x 2 1E-5 7",
+      "1 +2.5 3",
+      "1 2e 3",
+      "1 2e+ 3",
+      "1 -e3",
+      "1 . 2",
+      "1 1e400 2",
+      "1 -1e400 2",
+      "1 1e-400 2",
+      "1 0x1p3 2",
+      "1 inf 2",
+      "3.4028235e38 3.4028236e38 1" })
+  {
+    expect_same_as_extractors<double>(s);
+    expect_same_as_extractors<float>(s);
+  }
+}
+
+/* Test: Whitespace between values read using back_insert().
+ * 
+ * Whitespace is skipped straight out of the stream buffer where possible, but
+ * the result must be exactly the same as with the extractors - including for
+ * whitespace split across refills of the stream buffer, and trailing
+ * whitespace at the end of the input.
+ */
+TEST(BackInsert, Whitespace)
+{
+  auto padded = std::string{};
+  for (auto n = 0; n < 500; ++n)
+    padded += std::string(static_cast<std::size_t>(n % 37), (n % 2) ? ' ' : '\t') + "\r\n\v\f" + std::to_string(n * 7919) + "        ";
+  
+  expect_same_as_extractors<int>(padded);
+  expect_same_as_extractors<double>(padded);
+  expect_same_as_extractors<int>(padded + "\x85 1");
+  expect_same_as_extractors<int>("   1   \n  2 \x01 3");
+  expect_same_as_extractors<int>("1 2 3", std::ios_base::dec);
+  
+  auto r = std::vector<int>{};
+  
+  std::istringstream iss{"                1 \t\n   "};
+  iss.imbue(std::locale::classic());
+  
+  EXPECT_FALSE(iss >> std::back_insert(r));
+  EXPECT_TRUE(iss.eof());
+  EXPECT_TRUE(iss.fail());
+  EXPECT_EQ(std::vector<int>{ 1 }, r);
+}
+
+/* Test: Reserving space when using back_insert_n() and back_insert() with
+ * estimate_size.
+ * 
+ * back_insert_n() should reserve space for all the values it may read up
+ * front, if the range can reserve space. back_insert() with estimate_size
+ * should reserve space for the values estimated to be left in the stream,
+ * and not much more. Either way, the values read must be the same.
+ */
+TEST(BackInsert, Reserve)
+{
+  {
+    auto v = std::vector<int>{ 1 };
+    
+    std::istringstream iss{"2 3"};
+    
+    EXPECT_FALSE(iss >> std::back_insert_n(v, 100));
+    EXPECT_EQ((std::vector<int>{ 1, 2, 3 }), v);
+    EXPECT_LE(std::size_t{101}, v.capacity());
+  }
+  {
+    auto l = std::list<int>{};
+    
+    std::istringstream iss{"2 3"};
+    
+    EXPECT_FALSE(iss >> std::back_insert_n(l, 100));
+    EXPECT_EQ((std::list<int>{ 2, 3 }), l);
+  }
+  
+  auto input = std::string{};
+  for (auto n = 0; n < 10000; ++n)
+    input += std::to_string(1000 + n % 9000) + ' ';
+  
+  {
+    auto v = std::vector<int>{};
+    
+    std::istringstream iss{input};
+    auto p = std::back_insert(std::estimate_size, v);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_TRUE(iss.eof());
+    EXPECT_EQ(std::size_t{10000}, p.count);
+    EXPECT_EQ(std::size_t{10000}, v.size());
+    EXPECT_EQ(1000, v.front());
+    EXPECT_EQ(1000 + 9999 % 9000, v.back());
+    EXPECT_GT(std::size_t{11000}, v.capacity());
+  }
+  {
+    auto l = std::list<int>{};
+    
+    std::istringstream iss{input};
+    
+    EXPECT_FALSE(iss >> std::back_insert(std::estimate_size, l));
+    EXPECT_EQ(std::size_t{10000}, l.size());
+  }
+}
+
+/* Test: Reading one value at a time with back_insert_n().
+ * 
+ * Reserving space for the next value on every read should grow the range
+ * geometrically, like push_back() does, not reallocate every time.
+ */
+TEST(BackInsertN, RepeatedReads)
+{
+  auto input = std::string{};
+  for (auto n = 0; n < 10000; ++n)
+    input += std::to_string(n) + ' ';
+  
+  auto v = std::vector<int>{};
+  auto reallocations = 0;
+  
+  std::istringstream iss{input};
+  
+  for (auto capacity = v.capacity(); iss >> std::back_insert_n(v, 1); capacity = v.capacity())
+  {
+    if (v.capacity() != capacity)
+      ++reallocations;
+  }
+  
+  EXPECT_EQ(std::size_t{10000}, v.size());
+  EXPECT_EQ(9999, v.back());
+  EXPECT_GT(40, reallocations);
+}
+
+/* Test: Input from a stream with its own character traits.
+ * 
+ * Such streams have no num_get facet, but strings can still be read from them.
+ */
+TEST(BackInsert, CustomTraits)
+{
+  struct custom_traits : std::char_traits<char> {};
+  using custom_string = std::basic_string<char, custom_traits>;
+  
+  auto r = std::vector<custom_string>{};
+  
+  std::basic_istringstream<char, custom_traits> iss{custom_string{"one two three"}};
+  
+  EXPECT_FALSE(iss >> std::back_insert(r));
+  EXPECT_TRUE(iss.eof());
+  
+  ASSERT_EQ(std::size_t{3}, r.size());
+  EXPECT_TRUE(r.at(0) == "one");
+  EXPECT_TRUE(r.at(2) == "three");
+}
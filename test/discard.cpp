@@ -0,0 +1,177 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/* 
+ * This file contains the tests for the proposed range streaming facilities -
+ * specifically the input version that discards the values read.
+ * 
+ * These tests are not meant to be exhaustive, merely illustrative.
+ */
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <rangeio>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+/* 
+ * A type that isn't whitespace delimited: a single character in brackets.
+ */
+struct bracketed
+{
+  char c;
+};
+
+auto operator>>(std::istream& in, bracketed& b) -> std::istream&
+{
+  auto open = char{};
+  auto close = char{};
+  
+  if ((in >> open >> b.c >> close) && ((open != '[') || (close != ']')))
+    in.setstate(std::ios_base::failbit);
+  
+  return in;
+}
+
+} // anonymous namespace
+
+/* Test: Verify which types are whitespace delimited.
+ */
+TEST(Discard, Types)
+{
+  EXPECT_FALSE(std::is_whitespace_delimited<int>::value);
+  EXPECT_FALSE(std::is_whitespace_delimited<double>::value);
+  EXPECT_TRUE(std::is_whitespace_delimited<std::string>::value);
+  EXPECT_TRUE(std::is_whitespace_delimited<std::wstring>::value);
+  EXPECT_FALSE(std::is_whitespace_delimited<char>::value);
+  EXPECT_FALSE(std::is_whitespace_delimited<bracketed>::value);
+}
+
+/* Test: Discarding values.
+ * 
+ * discard() should skip up to n values, counting them but not storing any,
+ * and leave the rest of the stream to be read.
+ */
+TEST(Discard, Input)
+{
+  {
+    std::istringstream iss{"id name  score\n1 alice 3.5\n2 bob 4.25\n"};
+    
+    auto p = std::discard<std::string>(3);
+    
+    EXPECT_TRUE(iss >> p);
+    EXPECT_EQ(std::size_t{3}, p.count);
+    EXPECT_EQ(std::size_t{0}, p.stored);
+    
+    auto id = 0;
+    EXPECT_TRUE(iss >> id >> std::discard<std::string>(1));
+    EXPECT_EQ(1, id);
+    
+    auto score = 0.0;
+    EXPECT_TRUE(iss >> score);
+    EXPECT_EQ(3.5, score);
+  }
+  
+  {
+    auto input = std::string{};
+    for (auto n = 0; n < 10000; ++n)
+      input += std::to_string(n * 31) + ((n % 7) ? " " : "\n\t  ");
+    
+    std::istringstream iss{input};
+    
+    auto p = std::discard<int>();
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_TRUE(iss.eof());
+    EXPECT_EQ(std::size_t{10000}, p.count);
+    EXPECT_EQ(std::size_t{0}, p.stored);
+  }
+  
+  {
+    std::istringstream iss{"1,2,3 4"};
+    
+    auto p = std::discard<int>();
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_FALSE(iss.eof());
+    EXPECT_EQ(std::size_t{1}, p.count);
+  }
+  
+  {
+    std::istringstream iss{"12ab 3"};
+    
+    auto p = std::discard<int>();
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_EQ(std::size_t{1}, p.count);
+  }
+  
+  {
+    std::istringstream iss{"name age"};
+    
+    auto p = std::discard<int>(2);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_EQ(std::size_t{0}, p.count);
+  }
+  
+  {
+    std::istringstream iss{"[a] [b] (c) [d]"};
+    
+    auto p = std::discard<bracketed>();
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_FALSE(iss.eof());
+    EXPECT_EQ(std::size_t{2}, p.count);
+  }
+  
+  {
+    std::wistringstream iss{L"été hiver  printemps"};
+    
+    auto p = std::discard<std::wstring>();
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_TRUE(iss.eof());
+    EXPECT_EQ(std::size_t{3}, p.count);
+  }
+}
+
+/* Test: Discarding values with the stream width set.
+ * 
+ * With the width set, a string ends before the next whitespace if it is too
+ * long, so values should be read and thrown away instead.
+ */
+TEST(Discard, Formatting)
+{
+  std::istringstream iss{"abcdef gh"};
+  iss.width(4);
+  
+  auto p = std::discard<std::string>(2);
+  
+  EXPECT_TRUE(iss >> p);
+  EXPECT_EQ(std::size_t{2}, p.count);
+  EXPECT_EQ(0, iss.width());
+  
+  auto rest = std::string{};
+  EXPECT_TRUE(iss >> rest);
+  EXPECT_EQ("gh", rest);
+}
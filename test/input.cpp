@@ -0,0 +1,364 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* 
+ * This file contains the tests for the proposed range streaming facilities -
+ * specifically the generic input function that takes a user-defined input
+ * behaviour.
+ * 
+ * These tests are not meant to be exhaustive, merely illustrative.
+ */
+
+#include <array>
+#include <iterator>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <rangeio>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+/* 
+ * An input behaviour that only has the plain read() function, and reads
+ * every other value into the range, skipping the rest.
+ */
+template <typename Range>
+struct every_other_behaviour
+{
+  using iterator = decltype(std::begin(std::declval<Range&>()));
+  
+  auto prepare(Range& r, iterator) -> std::tuple<bool, iterator>
+  {
+    skip_ = false;
+    return std::make_tuple(true, std::begin(r));
+  }
+  
+  template <typename CharT, typename Traits>
+  auto read(std::basic_istream<CharT, Traits>& in, Range& r, iterator i) -> std::tuple<bool, iterator, bool, bool>
+  {
+    auto v = 0;
+    if ((i == std::end(r)) || !(in >> v))
+      return std::make_tuple(false, i, false, false);
+    
+    skip_ = !skip_;
+    if (!skip_)
+      return std::make_tuple(true, i, true, false);
+    
+    *i++ = v;
+    return std::make_tuple(i != std::end(r), i, true, true);
+  }
+  
+  bool skip_ = false;
+};
+
+/* 
+ * An input behaviour that only has read_bulk(), and appends the values it
+ * reads to a vector, storing only the ones that aren't empty. It counts how
+ * many times it is called.
+ */
+struct nonempty_bulk_behaviour
+{
+  using iterator = std::vector<std::string>::iterator;
+  
+  auto prepare(std::vector<std::string>& r, iterator) -> std::tuple<bool, iterator>
+  {
+    return std::make_tuple(true, r.end());
+  }
+  
+  template <typename CharT, typename Traits>
+  auto read_bulk(std::basic_istream<CharT, Traits>&, std::vector<std::string>& r, iterator, std::rangeio_detail::input_source<CharT, Traits>& source,
+      std::size_t max) -> std::tuple<bool, iterator, std::size_t, std::size_t>
+  {
+    ++calls_;
+    
+    auto read = std::size_t{0};
+    auto stored = std::size_t{0};
+    
+    for (auto v = std::string{}; (read != max) && source.extract(v); ++read)
+    {
+      if (v != "-")
+      {
+        r.push_back(v);
+        ++stored;
+      }
+    }
+    
+    return std::make_tuple(read == max, r.end(), read, stored);
+  }
+  
+  int calls_ = 0;
+};
+
+/* 
+ * A stream buffer that throws away its output, counting how many times it is
+ * flushed.
+ */
+struct flush_counting_buffer : std::streambuf
+{
+  auto sync() -> int override
+  {
+    ++flushes_;
+    return 0;
+  }
+  
+  int flushes_ = 0;
+};
+
+} // anonymous namespace
+
+/* Test: Input with a user-defined behaviour.
+ * 
+ * A behaviour that only provides the plain read() function, without the
+ * input source, should be used as-is.
+ */
+TEST(Input, UserBehaviour)
+{
+  auto r = std::array<int, 3>{};
+  
+  std::istringstream iss{"1 2 3 4 5 6"};
+  iss.imbue(std::locale::classic());
+  
+  auto p = std::input(r, r.begin(), every_other_behaviour<std::array<int, 3>>{});
+  
+  EXPECT_TRUE(iss >> p);
+  EXPECT_FALSE(iss.eof());
+  
+  EXPECT_EQ(std::size_t{5}, p.count);
+  EXPECT_EQ(std::size_t{3}, p.stored);
+  EXPECT_TRUE(r.end() == p.next);
+  
+  EXPECT_EQ(1, r.at(0));
+  EXPECT_EQ(3, r.at(1));
+  EXPECT_EQ(5, r.at(2));
+}
+
+/* Test: Input with a user-defined behaviour that reads in bulk.
+ * 
+ * A behaviour that provides read_bulk() should have it called instead of
+ * read(), with count and stored updated from its results, and the formatting
+ * restored before every value it reads.
+ */
+TEST(Input, UserBulkBehaviour)
+{
+  auto r = std::vector<std::string>{};
+  
+  auto input = std::string{};
+  for (auto n = 0; n < 5000; ++n)
+    input += (n % 2) ? "- " : "abcdef ";
+  
+  std::istringstream iss{input};
+  iss.width(4);
+  
+  auto p = std::input(r, r.end(), nonempty_bulk_behaviour{});
+  
+  EXPECT_FALSE(iss >> p);
+  EXPECT_TRUE(iss.eof());
+  
+  EXPECT_EQ(std::size_t{7500}, p.count);
+  EXPECT_EQ(std::size_t{5000}, p.stored);
+  EXPECT_EQ(std::size_t{5000}, r.size());
+  EXPECT_EQ("abcd", r.at(0));
+  EXPECT_EQ("ef", r.at(1));
+  EXPECT_LT(p.op_.calls_, 10);
+}
+
+/* Test: Input from a tied stream.
+ * 
+ * The tied stream should be flushed once for the whole input operation, not
+ * once for every value read, and the stream should be tied again afterwards.
+ * The values read and the final stream state should be the same either way.
+ */
+TEST(Input, TiedStream)
+{
+  flush_counting_buffer out_buf;
+  std::ostream out{&out_buf};
+  
+  auto input = std::string{};
+  for (auto n = 0; n < 1000; ++n)
+    input += std::to_string(n) + " ";
+  
+  {
+    auto r = std::vector<int>{};
+    
+    std::istringstream iss{input};
+    iss.tie(&out);
+    
+    EXPECT_FALSE(iss >> std::back_insert(r));
+    EXPECT_TRUE(iss.eof());
+    
+    EXPECT_EQ(std::size_t{1000}, r.size());
+    EXPECT_EQ(999, r.back());
+    EXPECT_EQ(1, out_buf.flushes_);
+    EXPECT_EQ(&out, iss.tie());
+  }
+  
+  {
+    auto r = std::vector<std::string>{};
+    
+    std::istringstream iss{input};
+    iss.tie(&out);
+    
+    EXPECT_FALSE(iss >> std::back_insert(r));
+    EXPECT_TRUE(iss.eof());
+    
+    EXPECT_EQ(std::size_t{1000}, r.size());
+    EXPECT_EQ("999", r.back());
+    EXPECT_EQ(2, out_buf.flushes_);
+    EXPECT_EQ(&out, iss.tie());
+  }
+  
+  {
+    auto r = std::vector<int>{};
+    
+    std::istringstream iss{"1 2 x"};
+    iss.tie(&out);
+    
+    EXPECT_FALSE(iss >> std::back_insert(r));
+    EXPECT_FALSE(iss.eof());
+    
+    EXPECT_EQ((std::vector<int>{ 1, 2 }), r);
+    EXPECT_EQ(3, out_buf.flushes_);
+    EXPECT_EQ(&out, iss.tie());
+  }
+}
+
+/* Test: Input from a wide stream.
+ * 
+ * Whitespace in wide streams is skipped with the ctype facet, which should
+ * leave the stream in the same state as the extractors do.
+ */
+TEST(Input, WideStream)
+{
+  auto r = std::vector<int>{};
+  
+  std::wistringstream iss{L" 1\t 2\n3   "};
+  
+  EXPECT_FALSE(iss >> std::back_insert(r));
+  EXPECT_TRUE(iss.eof());
+  EXPECT_TRUE(iss.fail());
+  EXPECT_FALSE(iss.bad());
+  
+  EXPECT_EQ((std::vector<int>{ 1, 2, 3 }), r);
+}
+
+/* Test: Input that recovers from malformed values.
+ * 
+ * Malformed tokens - including ones that start with a well-formed value -
+ * should be skipped as a whole, counted in skipped, and have the positions at
+ * which they start recorded, with the well-formed values around them all
+ * read - however they are read.
+ */
+TEST(Input, Recovering)
+{
+  {
+    auto r = std::vector<int>{};
+    
+    std::istringstream iss{"1 2 x3 4 -- 5\t12ab 6 +\n7"};
+    
+    auto p = std::recovering(std::back_insert(r));
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_TRUE(iss.eof());
+    EXPECT_FALSE(iss.bad());
+    
+    EXPECT_EQ((std::vector<int>{ 1, 2, 4, 5, 6, 7 }), r);
+    EXPECT_EQ(std::size_t{6}, p.count);
+    EXPECT_EQ(std::size_t{6}, p.stored);
+    EXPECT_EQ(std::size_t{4}, p.skipped);
+    EXPECT_EQ((std::vector<std::streamoff>{ 4, 9, 14, 21 }), p.bad_positions);
+  }
+  
+  {
+    auto r = std::vector<short>{};
+    
+    std::istringstream iss{"1 99999 2 3,4 5"};
+    
+    auto p = std::recovering(std::back_insert(r));
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_TRUE(iss.eof());
+    
+    EXPECT_EQ((std::vector<short>{ 1, 2, 5 }), r);
+    EXPECT_EQ(std::size_t{2}, p.skipped);
+    EXPECT_EQ((std::vector<std::streamoff>{ 2, 10 }), p.bad_positions);
+  }
+  
+  {
+    auto r = std::vector<std::string>{};
+    
+    std::istringstream iss{"ab  cd"};
+    
+    auto p = std::recovering(std::back_insert(r));
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_EQ((std::vector<std::string>{ "ab", "cd" }), r);
+    EXPECT_EQ(std::size_t{0}, p.skipped);
+  }
+  
+  {
+    auto r = std::array<double, 3>{};
+    
+    std::istringstream iss{"nope 1.5 bad 2.5 worse 3.5 4.5"};
+    
+    auto p = std::recovering(std::overwrite(r), 2);
+    
+    EXPECT_TRUE(iss >> p);
+    
+    EXPECT_EQ(1.5, r.at(0));
+    EXPECT_EQ(2.5, r.at(1));
+    EXPECT_EQ(3.5, r.at(2));
+    EXPECT_EQ(std::size_t{3}, p.count);
+    EXPECT_EQ(std::size_t{3}, p.skipped);
+    EXPECT_EQ((std::vector<std::streamoff>{ 0, 9 }), p.bad_positions);
+  }
+  
+  {
+    auto r = std::array<int, 3>{};
+    
+    std::istringstream iss{"1 ? 2 3 4 5"};
+    
+    auto p = std::input(r, r.begin(), every_other_behaviour<std::array<int, 3>>{});
+    
+    EXPECT_TRUE(iss >> std::recovering(std::move(p)));
+    EXPECT_EQ(1, r.at(0));
+    EXPECT_EQ(3, r.at(1));
+    EXPECT_EQ(5, r.at(2));
+  }
+  
+  {
+    auto r = std::vector<int>{};
+    
+    std::istringstream iss{"1 x 2"};
+    
+    EXPECT_FALSE(iss >> std::back_insert(r));
+    EXPECT_FALSE(iss.eof());
+    EXPECT_EQ(std::vector<int>{ 1 }, r);
+  }
+  
+  {
+    auto r = std::vector<int>{};
+    
+    std::istringstream iss{"1 12ab"};
+    
+    EXPECT_FALSE(iss >> std::back_insert(r));
+    EXPECT_EQ((std::vector<int>{ 1, 12 }), r);
+  }
+}
@@ -21,9 +21,12 @@
  * These tests are not meant to be exhaustive, merely illustrative.
  */
 
+#include <ios>
 #include <iterator>
 #include <list>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -31,6 +34,30 @@
 
 #include "gtest/gtest.h"
 
+namespace {
+
+/* 
+ * A stream buffer that throws instead of reporting the end of its contents.
+ */
+struct throwing_buffer : std::stringbuf
+{
+  explicit throwing_buffer(std::string const& s) :
+    std::stringbuf{s}
+  {}
+  
+  auto underflow() -> int_type override
+  {
+    auto const c = std::stringbuf::underflow();
+    
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+      throw std::runtime_error{"end of input"};
+    
+    return c;
+  }
+};
+
+} // anonymous namespace
+
 /* Test: Verify the types associated with insert() are correct.
  * 
  * The return value of insert() should be an object with a size_t member
@@ -237,3 +264,110 @@ TEST(InsertN, Input)
     EXPECT_EQ(-.1, r.at(3));
   }
 }
+
+/* Test: Input into a range using bulk_insert() and bulk_insert_n().
+ * 
+ * The values read should end up at the insert position in order, exactly as
+ * with insert(), and next, count and stored should be the same - including
+ * when input fails midway.
+ */
+TEST(BulkInsert, Input)
+{
+  {
+    auto r = std::vector<int>{ 10, 20, 30 };
+    
+    std::istringstream iss{"1 2 3 x"};
+    
+    auto p = std::bulk_insert(r, r.begin() + 1);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_FALSE(iss.eof());
+    EXPECT_TRUE(iss.fail());
+    EXPECT_FALSE(iss.bad());
+    
+    EXPECT_EQ((std::vector<int>{ 10, 1, 2, 3, 20, 30 }), r);
+    EXPECT_EQ(std::size_t{3}, p.count);
+    EXPECT_EQ(std::size_t{3}, p.stored);
+    EXPECT_TRUE(r.begin() + 4 == p.next);
+  }
+  {
+    auto r = std::vector<int>{ 10, 20 };
+    
+    std::istringstream iss{"1 2 3"};
+    
+    auto p = std::bulk_insert_n(r, r.cbegin(), 2);
+    
+    EXPECT_TRUE(iss >> p);
+    EXPECT_EQ((std::vector<int>{ 1, 2, 10, 20 }), r);
+    EXPECT_EQ(std::size_t{2}, p.count);
+    EXPECT_EQ(std::size_t{2}, p.stored);
+    EXPECT_TRUE(r.cbegin() + 2 == p.next);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_TRUE(iss.eof());
+    EXPECT_EQ((std::vector<int>{ 1, 2, 3, 10, 20 }), r);
+    EXPECT_EQ(std::size_t{1}, p.count);
+    EXPECT_TRUE(r.cbegin() + 3 == p.next);
+  }
+  {
+    auto r = std::list<int>{ 10, 20 };
+    
+    std::istringstream iss{"x"};
+    
+    auto p = std::bulk_insert(r, std::next(r.begin()));
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_EQ((std::list<int>{ 10, 20 }), r);
+    EXPECT_EQ(std::size_t{0}, p.count);
+    EXPECT_TRUE(std::next(r.begin()) == p.next);
+  }
+  {
+    auto s = std::string{"<>"};
+    
+    std::istringstream iss{"a b c"};
+    
+    EXPECT_FALSE(iss >> std::bulk_insert(s, s.begin() + 1));
+    EXPECT_EQ("<abc>", s);
+  }
+  {
+    auto r = std::vector<int>(1000000, -1);
+    
+    auto input = std::string{};
+    for (auto n = 0; n < 100000; ++n)
+      input += std::to_string(n) + ' ';
+    
+    std::istringstream iss{input};
+    
+    auto p = std::bulk_insert(r, r.begin() + 500000);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_EQ(std::size_t{1100000}, r.size());
+    EXPECT_EQ(-1, r.at(499999));
+    EXPECT_EQ(0, r.at(500000));
+    EXPECT_EQ(99999, r.at(599999));
+    EXPECT_EQ(-1, r.at(600000));
+    EXPECT_TRUE(r.begin() + 600000 == p.next);
+  }
+}
+
+/* Test: Error checking when the stream throws on badbit.
+ * 
+ * The values read before the exception should be inserted, and next should
+ * be a valid iterator to the position after them.
+ */
+TEST(BulkInsert, ExceptionsErrorChecking)
+{
+  auto r = std::vector<int>{ 10, 20 };
+  
+  throwing_buffer sb{"1 2 3"};
+  std::istream in{&sb};
+  in.exceptions(std::ios_base::badbit);
+  
+  auto p = std::bulk_insert(r, r.begin() + 1);
+  
+  EXPECT_ANY_THROW(in >> p);
+  EXPECT_TRUE(in.bad());
+  EXPECT_EQ((std::vector<int>{ 10, 1, 2, 20 }), r);
+  EXPECT_EQ(std::size_t{2}, p.count);
+  EXPECT_TRUE(r.begin() + 3 == p.next);
+}
@@ -22,9 +22,14 @@
 
 #include <array>
 #include <forward_list>
+#include <ios>
 #include <iterator>
+#include <limits>
 #include <list>
+#include <locale>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -32,6 +37,47 @@
 
 #include "gtest/gtest.h"
 
+namespace {
+
+/* 
+ * Numeric punctuation with thousands grouping, to test input with a locale
+ * other than the classic one.
+ */
+struct grouping_numpunct : std::numpunct<char>
+{
+  auto do_thousands_sep() const -> char override
+  {
+    return '\'';
+  }
+  
+  auto do_grouping() const -> std::string override
+  {
+    return "\3";
+  }
+};
+
+/* 
+ * A stream buffer that throws instead of reporting the end of its contents.
+ */
+struct throwing_buffer : std::stringbuf
+{
+  explicit throwing_buffer(std::string const& s) :
+    std::stringbuf{s}
+  {}
+  
+  auto underflow() -> int_type override
+  {
+    auto const c = std::stringbuf::underflow();
+    
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+      throw std::runtime_error{"end of input"};
+    
+    return c;
+  }
+};
+
+} // anonymous namespace
+
 /* Test: Verify the types associated with overwrite() are correct.
  * 
  * The return value of overwrite() should be an object with a size_t member
@@ -163,6 +209,29 @@ TEST(Overwrite, ErrorChecking)
   }
 }
 
+/* Test: Error checking when the stream throws on badbit.
+ * 
+ * The values read before the exception should be in the range, counted in
+ * count and stored, and next should be the position after them.
+ */
+TEST(Overwrite, ExceptionsErrorChecking)
+{
+  auto r = std::array<int, 8>{};
+  
+  throwing_buffer sb{"1 2 3 4 5"};
+  std::istream in{&sb};
+  in.exceptions(std::ios_base::badbit);
+  
+  auto p = std::overwrite(r);
+  
+  EXPECT_ANY_THROW(in >> p);
+  EXPECT_TRUE(in.bad());
+  EXPECT_EQ((std::array<int, 8>{{ 1, 2, 3, 4, 0, 0, 0, 0 }}), r);
+  EXPECT_EQ(std::size_t{4}, p.count);
+  EXPECT_EQ(std::size_t{4}, p.stored);
+  EXPECT_TRUE((r.begin() + 4) == p.next);
+}
+
 /* Test: Formatting when using overwrite().
  * 
  * Whatever the formatting state at the beginning of the input of a streamed
@@ -205,3 +274,49 @@ TEST(Overwrite, Formatting)
     EXPECT_EQ(0x10, r.at(2));
   }
 }
+
+/* Test: Input into a range using overwrite(), with the stream's locale.
+ * 
+ * Arithmetic values should be read with the stream's num_get facet, just like
+ * their extractors would, including the range checks for short and int.
+ */
+TEST(Overwrite, Locale)
+{
+  {
+    auto r = std::vector<long>(3);
+    
+    std::istringstream iss{"1'234 -5'678'901 42"};
+    iss.imbue(std::locale{std::locale::classic(), new grouping_numpunct});
+    
+    EXPECT_TRUE(iss >> overwrite(r));
+    EXPECT_EQ(1234L, r.at(0));
+    EXPECT_EQ(-5678901L, r.at(1));
+    EXPECT_EQ(42L, r.at(2));
+  }
+  {
+    auto r = std::array<short, 3>{};
+    
+    std::istringstream iss{"1 70000 2"};
+    iss.imbue(std::locale::classic());
+    
+    auto p = overwrite(r);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_TRUE(iss.fail());
+    EXPECT_FALSE(iss.bad());
+    
+    EXPECT_EQ(std::size_t{1}, p.count);
+    EXPECT_EQ(1, r.at(0));
+    EXPECT_EQ(std::numeric_limits<short>::max(), r.at(1));
+  }
+  {
+    auto b = std::array<bool, 2>{};
+    
+    std::istringstream iss{"true false"};
+    iss.setf(std::ios_base::boolalpha);
+    
+    EXPECT_TRUE(iss >> overwrite(b));
+    EXPECT_TRUE(b.at(0));
+    EXPECT_FALSE(b.at(1));
+  }
+}
@@ -0,0 +1,199 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/* 
+ * This file contains the tests for the proposed range streaming facilities -
+ * specifically the binary input versions.
+ * 
+ * These tests are not meant to be exhaustive, merely illustrative.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <rangeio>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+/* 
+ * Writes the object representations of the values in v to a string.
+ */
+template <typename T>
+auto binary_string(std::vector<T> const& v) -> std::string
+{
+  return std::string(reinterpret_cast<char const*>(v.data()), v.size() * sizeof(T));
+}
+
+/* 
+ * A stream buffer that throws whenever it is read.
+ */
+struct throwing_buffer : std::streambuf
+{
+  auto underflow() -> int_type override
+  {
+    throw std::runtime_error{"unreadable"};
+  }
+};
+
+} // anonymous namespace
+
+/* Test: Input with read_binary().
+ * 
+ * read_binary() should fill the range with the object representations read
+ * from the stream, leaving anything after them in the stream, and stop early
+ * - with eofbit and failbit set - if the stream runs out.
+ */
+TEST(ReadBinary, Input)
+{
+  auto values = std::vector<double>{};
+  for (auto n = 0; n < 10000; ++n)
+    values.push_back(n * 0.25 - 7.0);
+  
+  {
+    auto r = std::vector<double>(10000);
+    
+    std::istringstream iss{binary_string(values) + "rest"};
+    
+    auto p = std::read_binary(r);
+    
+    EXPECT_TRUE(iss >> p);
+    EXPECT_EQ(std::size_t{10000}, p.count);
+    EXPECT_EQ(std::size_t{10000}, p.stored);
+    EXPECT_TRUE(r.end() == p.next);
+    EXPECT_EQ(values, r);
+    
+    auto rest = std::string{};
+    iss >> rest;
+    EXPECT_EQ("rest", rest);
+  }
+  
+  {
+    auto r = std::array<std::int32_t, 4>{{ -1, -1, -1, -1 }};
+    
+    std::istringstream iss{binary_string(std::vector<std::int32_t>{ 1, 2 })};
+    
+    auto p = std::read_binary(r);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_TRUE(iss.eof());
+    EXPECT_FALSE(iss.bad());
+    EXPECT_EQ(std::size_t{2}, p.count);
+    EXPECT_EQ(std::size_t{2}, p.stored);
+    EXPECT_TRUE(r.begin() + 2 == p.next);
+    EXPECT_EQ(1, r.at(0));
+    EXPECT_EQ(2, r.at(1));
+    EXPECT_EQ(-1, r.at(3));
+  }
+  
+  {
+    auto r = std::vector<std::int32_t>(3, 0x7f7f7f7f);
+    
+    std::istringstream iss{binary_string(std::vector<std::int32_t>{ 0x11111111, 0x22222222 }).substr(0, 6)};
+    
+    auto p = std::read_binary(r);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_TRUE(iss.eof());
+    EXPECT_TRUE(iss.fail());
+    EXPECT_FALSE(iss.bad());
+    EXPECT_EQ(std::size_t{1}, p.count);
+    EXPECT_TRUE(r.begin() + 1 == p.next);
+    EXPECT_EQ((std::vector<std::int32_t>{ 0x11111111, 0x7f7f7f7f, 0x7f7f7f7f }), r);
+  }
+}
+
+/* Test: Error checking with read_binary().
+ * 
+ * If the stream buffer throws, badbit should be set - and not eofbit, since
+ * the stream didn't end.
+ */
+TEST(ReadBinary, ErrorChecking)
+{
+  auto r = std::vector<std::int32_t>(3, 0x7f7f7f7f);
+  
+  throwing_buffer sb;
+  std::istream in{&sb};
+  
+  auto p = std::read_binary(r);
+  
+  EXPECT_FALSE(in >> p);
+  EXPECT_TRUE(in.bad());
+  EXPECT_FALSE(in.eof());
+  EXPECT_EQ(std::size_t{0}, p.count);
+  EXPECT_EQ((std::vector<std::int32_t>(3, 0x7f7f7f7f)), r);
+}
+
+/* Test: Input with read_binary_n().
+ * 
+ * read_binary_n() should append at most n values to the range. A value cut
+ * short by the end of the stream should not be counted or left in the range.
+ */
+TEST(ReadBinaryN, Input)
+{
+  auto values = std::vector<std::uint16_t>{};
+  for (auto n = 0; n < 10000; ++n)
+    values.push_back(static_cast<std::uint16_t>(n * 7));
+  
+  {
+    auto r = std::vector<std::uint16_t>{ 42 };
+    
+    std::istringstream iss{binary_string(values)};
+    
+    auto p = std::read_binary_n(r, 9999);
+    
+    EXPECT_TRUE(iss >> p);
+    EXPECT_EQ(std::size_t{9999}, p.count);
+    EXPECT_EQ(std::size_t{9999}, p.stored);
+    EXPECT_TRUE(r.end() == p.next);
+    ASSERT_EQ(std::size_t{10000}, r.size());
+    EXPECT_EQ(42, r.front());
+    EXPECT_TRUE(std::equal(values.begin(), values.end() - 1, r.begin() + 1));
+  }
+  
+  {
+    auto r = std::vector<std::uint16_t>{};
+    
+    std::istringstream iss{binary_string(values) + "x"};
+    
+    auto p = std::read_binary_n(r, 20000);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_TRUE(iss.eof());
+    EXPECT_FALSE(iss.bad());
+    EXPECT_EQ(std::size_t{10000}, p.count);
+    EXPECT_EQ(std::size_t{10000}, p.stored);
+    EXPECT_EQ(values, r);
+  }
+  
+  {
+    auto r = std::vector<std::uint16_t>{};
+    
+    std::istringstream iss{"xy"};
+    iss.setstate(std::ios_base::eofbit);
+    
+    EXPECT_FALSE(iss >> std::read_binary_n(r, 1));
+    EXPECT_TRUE(r.empty());
+  }
+}
@@ -0,0 +1,162 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/* 
+ * This file contains the tests for the proposed range streaming facilities -
+ * specifically the lazy input range.
+ * 
+ * These tests are not meant to be exhaustive, merely illustrative.
+ */
+
+#include <cstddef>
+#include <iterator>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <rangeio>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+/* 
+ * Numeric punctuation with thousands grouping, to test input with a locale
+ * other than the classic one.
+ */
+struct grouping_numpunct : std::numpunct<char>
+{
+  auto do_thousands_sep() const -> char override
+  {
+    return '\'';
+  }
+  
+  auto do_grouping() const -> std::string override
+  {
+    return "\3";
+  }
+};
+
+} // anonymous namespace
+
+/* Test: Verify the types associated with read_lazy() are correct.
+ * 
+ * The range should have input iterators to the value type.
+ */
+TEST(ReadLazy, Types)
+{
+  std::istringstream iss;
+  
+  auto r = std::read_lazy<int>(iss);
+  
+  using iterator = decltype(r.begin());
+  
+  EXPECT_TRUE((std::is_same<std::input_iterator_tag, std::iterator_traits<iterator>::iterator_category>::value));
+  EXPECT_TRUE((std::is_same<int, std::iterator_traits<iterator>::value_type>::value));
+  EXPECT_TRUE((std::is_same<decltype(r.end()), iterator>::value));
+}
+
+/* Test: Reading with read_lazy().
+ * 
+ * Iterating over the range should read the values one at a time, stopping
+ * when the stream fails, with the formatting of the stream restored before
+ * every value, and the locale of the stream as it is when each value is
+ * read.
+ */
+TEST(ReadLazy, Input)
+{
+  {
+    std::istringstream iss{"1 2 3 4 x 6"};
+    
+    auto r = std::read_lazy<int>(iss);
+    auto v = std::vector<int>{};
+    
+    for (auto n : r)
+      v.push_back(n);
+    
+    EXPECT_EQ((std::vector<int>{ 1, 2, 3, 4 }), v);
+    EXPECT_EQ(std::size_t{4}, r.count);
+    EXPECT_TRUE(iss.fail());
+    EXPECT_FALSE(iss.eof());
+    EXPECT_TRUE(r.begin() == r.end());
+  }
+  
+  {
+    std::istringstream iss{"abcdefgh ij"};
+    iss.width(3);
+    
+    auto v = std::vector<std::string>{};
+    for (auto const& s : std::read_lazy<std::string>(iss))
+      v.push_back(s);
+    
+    EXPECT_EQ((std::vector<std::string>{ "abc", "def", "gh", "ij" }), v);
+    EXPECT_TRUE(iss.eof());
+    EXPECT_EQ(0, iss.width());
+  }
+  
+  {
+    std::istringstream iss{"10 20 30"};
+    
+    auto r = std::read_lazy<int>(iss);
+    auto i = r.begin();
+    
+    EXPECT_EQ(10, *i++);
+    EXPECT_EQ(20, *i);
+    EXPECT_TRUE(++i != r.end());
+    EXPECT_EQ(30, *i);
+    EXPECT_TRUE(++i == r.end());
+  }
+  
+  {
+    std::istringstream iss{"1000 2'000 3'000"};
+    
+    auto r = std::read_lazy<int>(iss);
+    auto i = r.begin();
+    
+    EXPECT_EQ(1000, *i);
+    
+    iss.imbue(std::locale{std::locale::classic(), new grouping_numpunct});
+    
+    EXPECT_EQ(2000, *++i);
+    EXPECT_EQ(3000, *++i);
+    EXPECT_TRUE(++i == r.end());
+    EXPECT_EQ(std::size_t{3}, r.count);
+  }
+}
+
+/* Test: Using read_lazy() as the source for write_all().
+ * 
+ * All of the values should be copied from the input stream to the output
+ * stream.
+ */
+TEST(ReadLazy, WriteAll)
+{
+  auto input = std::string{};
+  for (auto n = 0; n < 10000; ++n)
+    input += std::to_string(n) + " ";
+  
+  std::istringstream iss{input};
+  std::ostringstream oss;
+  
+  auto p = std::write_all(std::read_lazy<int>(iss), " ");
+  
+  EXPECT_TRUE(oss << p);
+  EXPECT_EQ(std::size_t{10000}, p.count);
+  EXPECT_TRUE(iss.eof());
+  EXPECT_EQ(input.substr(0, input.size() - 1), oss.str());
+}
@@ -0,0 +1,114 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/* 
+ * This file contains the tests for the proposed range streaming facilities -
+ * specifically the input versions that reduce the values read.
+ * 
+ * These tests are not meant to be exhaustive, merely illustrative.
+ */
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+#include <rangeio>
+
+#include "gtest/gtest.h"
+
+/* Test: Summing, counting and finding the least and greatest values.
+ * 
+ * Every value read should go into the result, and count should be the number
+ * of values read, exactly as if they had been read into a range.
+ */
+TEST(Reduce, Input)
+{
+  auto input = std::string{};
+  for (auto n = 1; n <= 10000; ++n)
+    input += std::to_string((n % 2) ? n : -n) + " ";
+  
+  {
+    std::istringstream iss{input};
+    
+    auto sum = 0LL;
+    auto p = std::sum_of<int>(sum);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_TRUE(iss.eof());
+    EXPECT_EQ(std::size_t{10000}, p.count);
+    EXPECT_EQ(std::size_t{10000}, p.stored);
+    EXPECT_EQ(-5000LL, sum);
+  }
+  
+  {
+    std::istringstream iss{input};
+    
+    auto least = 0;
+    auto p = std::min_of<int>(least);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_EQ(std::size_t{10000}, p.count);
+    EXPECT_EQ(-10000, least);
+  }
+  
+  {
+    std::istringstream iss{input};
+    
+    auto greatest = 100000;
+    auto p = std::max_of<int>(greatest);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_EQ(std::size_t{10000}, p.count);
+    EXPECT_EQ(9999, greatest);
+  }
+  
+  {
+    std::istringstream iss{"1.5 2.5 x 4"};
+    
+    auto n = std::size_t{1};
+    auto p = std::count_of<double>(n);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_FALSE(iss.eof());
+    EXPECT_EQ(std::size_t{2}, p.count);
+    EXPECT_EQ(std::size_t{3}, n);
+  }
+  
+  {
+    std::istringstream iss{""};
+    
+    auto least = 42;
+    auto p = std::min_of<int>(least);
+    
+    EXPECT_FALSE(iss >> p);
+    EXPECT_EQ(std::size_t{0}, p.count);
+    EXPECT_EQ(42, least);
+  }
+}
+
+/* Test: Folding with a user-supplied operation.
+ */
+TEST(Reduce, Fold)
+{
+  std::istringstream iss{"the quick brown fox"};
+  
+  auto initials = std::string{">"};
+  auto p = std::fold<std::string>(initials, [](std::string r, std::string&& s) { return r + s.front(); });
+  
+  EXPECT_FALSE(iss >> p);
+  EXPECT_EQ(std::size_t{4}, p.count);
+  EXPECT_EQ(">tqbf", initials);
+}
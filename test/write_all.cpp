@@ -22,13 +22,20 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <forward_list>
 #include <initializer_list>
+#include <ios>
 #include <iterator>
+#include <limits>
+#include <list>
+#include <locale>
 #include <sstream>
+#include <string>
 #include <type_traits>
+#include <vector>
 
-#include <rangeio>
+#include <rangeio_parallel>
 
 #include "gtest/gtest.h"
 
@@ -85,6 +92,158 @@ public:
   auto operator=(noncopyable_nonmoveable_range&&) -> noncopyable_nonmoveable_range& = delete;
 };
 
+/* 
+ * A type whose inserter changes the formatting state of the stream.
+ */
+struct format_changer
+{
+  int value;
+};
+
+auto operator<<(std::ostream& out, format_changer const& fc) -> std::ostream&
+{
+  out << fc.value;
+  out.setf(std::ios_base::hex, std::ios_base::basefield);
+  out.fill('#');
+  return out;
+}
+
+/* 
+ * A stream buffer that can hold only a fixed number of characters. Once it is
+ * full, all further output fails.
+ */
+template <std::size_t N>
+struct fixed_size_buffer : std::streambuf
+{
+  fixed_size_buffer()
+  {
+    setp(buffer, buffer + N);
+  }
+  
+  auto str() const -> std::string
+  {
+    return {pbase(), pptr()};
+  }
+  
+  char buffer[N];
+};
+
+/* 
+ * A stream buffer that discards its output, but counts how many times it is
+ * flushed.
+ */
+struct flush_counting_buffer : std::streambuf
+{
+  auto sync() -> int override
+  {
+    ++flushes;
+    return 0;
+  }
+  
+  int flushes = 0;
+};
+
+/* 
+ * A stream buffer that discards its output, but counts how many times its
+ * virtual output functions are called.
+ */
+struct call_counting_buffer : std::streambuf
+{
+  auto xsputn(char const*, std::streamsize n) -> std::streamsize override
+  {
+    ++calls;
+    return n;
+  }
+  
+  auto overflow(int_type c) -> int_type override
+  {
+    ++calls;
+    return traits_type::not_eof(c);
+  }
+  
+  int calls = 0;
+};
+
+/* 
+ * Writes the elements of a range one at a time, using the same formatting
+ * state for each element. This is what write_all() should be equivalent to.
+ */
+template <typename CharT, typename Range>
+auto write_one_by_one(std::basic_ostream<CharT>& fmt, Range const& r) -> std::basic_string<CharT>
+{
+  std::basic_ostringstream<CharT> out;
+  out.copyfmt(fmt);
+  
+  for (auto&& v : r)
+  {
+    out.width(fmt.width());
+    out << v;
+  }
+  
+  return out.str();
+}
+
+/* 
+ * Sets up a series of formatting states on a stream, calling f for each one.
+ */
+template <typename CharT, typename Func>
+auto for_each_format(Func f) -> void
+{
+  using std::ios_base;
+  
+  auto const flags = std::initializer_list<ios_base::fmtflags>{
+    ios_base::dec,
+    ios_base::hex | ios_base::showbase,
+    ios_base::hex | ios_base::uppercase | ios_base::showbase | ios_base::internal,
+    ios_base::oct | ios_base::showbase | ios_base::left,
+    ios_base::dec | ios_base::showpos | ios_base::internal,
+    ios_base::fixed,
+    ios_base::scientific | ios_base::uppercase | ios_base::showpos,
+    ios_base::fixed | ios_base::showpoint | ios_base::right,
+    ios_base::fixed | ios_base::scientific,
+  };
+  
+  for (auto fl : flags)
+  {
+    for (auto width : { 0, 1, 12, 30 })
+    {
+      for (auto precision : { 0, 3, 6, 17 })
+      {
+        std::basic_ostringstream<CharT> fmt;
+        fmt.imbue(std::locale::classic());
+        fmt.flags(fl);
+        fmt.width(width);
+        fmt.precision(precision);
+        fmt.fill(CharT('*'));
+        
+        f(fmt);
+      }
+    }
+  }
+}
+
+/* 
+ * Numeric punctuation with thousands grouping and a decimal comma, to test
+ * output with a locale other than the classic one.
+ */
+struct grouping_numpunct : std::numpunct<char>
+{
+  auto do_decimal_point() const -> char override
+  {
+    return ',';
+  }
+  
+  auto do_thousands_sep() const -> char override
+  {
+    return '.';
+  }
+  
+  auto do_grouping() const -> std::string override
+  {
+    return "\3";
+  }
+};
+
 } // anonymous namespace
 
 /* Test: Verify the types associated with the non-delimited write_all() are
@@ -243,3 +402,619 @@ TEST(WriteAll, Formatting)
     EXPECT_EQ("____1.00" "-___2.30" "____6.67" "-__0.123" "-___1.23", oss.str());
   }
 }
+
+/* Test: Direct formatting of contiguous arithmetic ranges.
+ * 
+ * Ranges of integers and floating point numbers are formatted directly into
+ * the stream buffer, but the output must be exactly the same as if each
+ * element were written with its own inserter.
+ */
+TEST(WriteAll, ContiguousArithmetic)
+{
+  auto const ll = std::vector<long long>{ 0, 1, -1, 42, -42, 1234567890123LL,
+    std::numeric_limits<long long>::max(), std::numeric_limits<long long>::min() };
+  auto const s = std::array<short, 4>{{ 0, -1, 255, std::numeric_limits<short>::min() }};
+  unsigned const u[] = { 0u, 7u, 8u, 4294967295u };
+  auto const d = std::vector<double>{ 0.0, -0.0, 1.0, -2.5, 0.1, 1.0 / 3.0, 6.02214076e23,
+    -1.602176634e-19, 1e300, 5e-324, std::numeric_limits<double>::infinity(),
+    -std::numeric_limits<double>::infinity() };
+  auto const f = std::vector<float>{ 0.1f, -3.25f, 1e-10f, 3.4e38f };
+  auto const ld = std::vector<long double>{ 0.1L, -1e-300L, 123456.789L };
+  
+  for_each_format<char>([&](std::ostream& fmt)
+  {
+    auto const check = [&fmt](std::string const& expected, std::ostringstream& out)
+    {
+      EXPECT_TRUE(out);
+      EXPECT_EQ(0, out.width());
+      EXPECT_EQ(expected, out.str()) << "flags: " << fmt.flags() << " width: " << fmt.width() << " precision: " << fmt.precision();
+    };
+    
+    { std::ostringstream out; out.copyfmt(fmt); out.width(fmt.width()); out << std::write_all(ll); check(write_one_by_one(fmt, ll), out); }
+    { std::ostringstream out; out.copyfmt(fmt); out.width(fmt.width()); out << std::write_all(s); check(write_one_by_one(fmt, s), out); }
+    { std::ostringstream out; out.copyfmt(fmt); out.width(fmt.width()); out << std::write_all(u); check(write_one_by_one(fmt, u), out); }
+    { std::ostringstream out; out.copyfmt(fmt); out.width(fmt.width()); out << std::write_all(d); check(write_one_by_one(fmt, d), out); }
+    { std::ostringstream out; out.copyfmt(fmt); out.width(fmt.width()); out << std::write_all(f); check(write_one_by_one(fmt, f), out); }
+    { std::ostringstream out; out.copyfmt(fmt); out.width(fmt.width()); out << std::write_all(ld); check(write_one_by_one(fmt, ld), out); }
+  });
+  
+  for_each_format<wchar_t>([&](std::wostream& fmt)
+  {
+    { std::wostringstream out; out.copyfmt(fmt); out.width(fmt.width()); out << std::write_all(ll); EXPECT_TRUE(write_one_by_one(fmt, ll) == out.str()); }
+    { std::wostringstream out; out.copyfmt(fmt); out.width(fmt.width()); out << std::write_all(d); EXPECT_TRUE(write_one_by_one(fmt, d) == out.str()); }
+  });
+}
+
+/* Test: Error checking with direct formatting of contiguous arithmetic ranges.
+ * 
+ * If the stream buffer can't take all the output, the stream should go bad,
+ * and the count and next members should reflect the values that were
+ * completely written.
+ */
+TEST(WriteAll, ContiguousArithmeticErrorChecking)
+{
+  auto const r = std::vector<int>{ 123, 456, 789 };
+  
+  fixed_size_buffer<7> sb;
+  std::ostream out{&sb};
+  
+  auto p = std::write_all(r);
+  
+  EXPECT_FALSE(out << p);
+  EXPECT_TRUE(out.bad());
+  EXPECT_EQ("1234567", sb.str());
+  EXPECT_EQ(std::size_t{2}, p.count);
+  EXPECT_TRUE(r.begin() + 2 == p.next);
+}
+
+/* Test: Block formatting of contiguous integer ranges.
+ * 
+ * Long ranges of integers are formatted in blocks, with eight digits at a
+ * time, but the output must be exactly the same as if each element were
+ * written with its own inserter - including when the width is too large for
+ * the blocks.
+ */
+TEST(WriteAll, IntegerBlocks)
+{
+  auto ull = std::vector<unsigned long long>{};
+  auto ll = std::vector<long long>{};
+  auto i = std::vector<int>{};
+  
+  for (auto n = 0ULL, step = 1ULL; n < 1000; ++n, step = step * 7 + n)
+  {
+    ull.push_back(step);
+    ll.push_back((n % 2) ? -static_cast<long long>(step >> 1) : static_cast<long long>(step >> 1));
+    i.push_back(static_cast<int>(step));
+  }
+  
+  ull.push_back(std::numeric_limits<unsigned long long>::max());
+  ll.push_back(std::numeric_limits<long long>::min());
+  ll.push_back(std::numeric_limits<long long>::max());
+  i.push_back(std::numeric_limits<int>::min());
+  
+  for_each_format<char>([&](std::ostream& fmt)
+  {
+    for (auto width : { fmt.width(), std::streamsize{100} })
+    {
+      fmt.width(width);
+      
+      { std::ostringstream out; out.copyfmt(fmt); out.width(width); out << std::write_all(ull); EXPECT_EQ(write_one_by_one(fmt, ull), out.str()); }
+      { std::ostringstream out; out.copyfmt(fmt); out.width(width); out << std::write_all(ll); EXPECT_EQ(write_one_by_one(fmt, ll), out.str()); }
+      { std::ostringstream out; out.copyfmt(fmt); out.width(width); out << std::write_all(i); EXPECT_EQ(write_one_by_one(fmt, i), out.str()); }
+    }
+  });
+}
+
+/* Test: Error checking with block formatting of contiguous integer ranges.
+ * 
+ * If the stream buffer can't take a whole block, the stream should go bad,
+ * and the count and next members should reflect the values that were
+ * completely written.
+ */
+TEST(WriteAll, IntegerBlocksErrorChecking)
+{
+  auto const r = std::vector<int>(100, 12);
+  
+  fixed_size_buffer<75> sb;
+  std::ostream out{&sb};
+  
+  auto p = std::write_all(r);
+  
+  EXPECT_FALSE(out << p);
+  EXPECT_TRUE(out.bad());
+  EXPECT_EQ(std::size_t{75}, sb.str().size());
+  EXPECT_EQ(std::size_t{37}, p.count);
+  EXPECT_TRUE(r.begin() + 37 == p.next);
+}
+
+/* Test: Staged output.
+ * 
+ * Directly written output is staged in a local buffer, and written to the
+ * stream buffer in large blocks. The output must be exactly the same as if
+ * each element were written with its own inserter, even for elements larger
+ * than the local buffer.
+ */
+TEST(WriteAll, StagedOutput)
+{
+  auto l = std::list<int>{};
+  for (auto n = 0; n < 5000; ++n)
+    l.push_back(n * 7919);
+  
+  auto const s = std::vector<std::string>{ "a", std::string(20000, 'b'), "c", std::string(9000, 'd') };
+  
+  {
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out.width(7);
+    
+    EXPECT_TRUE(out << std::write_all(l));
+    
+    std::ostringstream fmt;
+    fmt.imbue(std::locale::classic());
+    fmt.width(7);
+    EXPECT_EQ(write_one_by_one(fmt, l), out.str());
+  }
+  {
+    std::ostringstream out;
+    out.width(10000);
+    out.fill('*');
+    
+    std::ostringstream fmt;
+    fmt.width(10000);
+    fmt.fill('*');
+    
+    EXPECT_TRUE(out << std::write_all(s));
+    EXPECT_EQ(write_one_by_one(fmt, s), out.str());
+  }
+  {
+    call_counting_buffer sb;
+    std::ostream out{&sb};
+    out.imbue(std::locale::classic());
+    
+    EXPECT_TRUE(out << std::write_all(l, ' '));
+    EXPECT_GT(100, sb.calls);
+  }
+}
+
+/* Test: Error checking with staged output.
+ * 
+ * If the stream buffer only takes part of the staged output, the stream should
+ * go bad, and the count and next members should reflect the values that were
+ * completely written - even if the range can't be traversed backwards.
+ */
+TEST(WriteAll, StagedOutputErrorChecking)
+{
+  auto const l = std::forward_list<int>(6000, 12);
+  
+  fixed_size_buffer<10001> sb;
+  std::ostream out{&sb};
+  
+  auto p = std::write_all(l);
+  
+  EXPECT_FALSE(out << p);
+  EXPECT_TRUE(out.bad());
+  EXPECT_EQ(std::size_t{10001}, sb.str().size());
+  EXPECT_EQ(std::size_t{5000}, p.count);
+  EXPECT_TRUE(std::next(l.begin(), 5000) == p.next);
+}
+
+/* Test: Error checking when the stream throws on badbit.
+ * 
+ * When output fails part way through and the exception is rethrown, count and
+ * next should still say how much of the range was written.
+ */
+TEST(WriteAll, ExceptionsErrorChecking)
+{
+  {
+    auto const v = std::vector<char>{ 'a', 'b', 'c', 'd' };
+    
+    fixed_size_buffer<3> sb;
+    std::ostream out{&sb};
+    out.exceptions(std::ios_base::badbit);
+    
+    auto p = std::write_all(v);
+    
+    EXPECT_THROW(out << p, std::ios_base::failure);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ("abc", sb.str());
+    EXPECT_EQ(std::size_t{3}, p.count);
+    EXPECT_TRUE(v.begin() + 3 == p.next);
+  }
+  {
+    auto const v = std::vector<int>{ 1000, 2000, 3000 };
+    
+    fixed_size_buffer<12> sb;
+    std::ostream out{&sb};
+    out.imbue(std::locale{std::locale::classic(), new grouping_numpunct});
+    out.exceptions(std::ios_base::badbit);
+    
+    auto p = std::write_all(v);
+    
+    EXPECT_THROW(out << p, std::ios_base::failure);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ(std::size_t{2}, p.count);
+    EXPECT_TRUE(v.begin() + 2 == p.next);
+  }
+}
+
+/* Test: Parallel formatting.
+ * 
+ * Large random access ranges can be formatted on worker threads. The output,
+ * count and next should be exactly the same as when they are written
+ * sequentially, whatever the formatting, and ranges below the threshold or
+ * that can't be written directly should be written as usual.
+ */
+TEST(WriteAll, Parallel)
+{
+  auto v = std::vector<long>(100000);
+  for (auto n = 0u; n < v.size(); ++n)
+    v[n] = static_cast<long>(n) * ((n % 3) ? 104729L : -7919L);
+  
+  auto const s = std::vector<std::string>(30000, "text");
+  
+  for (auto flags : { std::ios_base::dec, std::ios_base::hex | std::ios_base::showbase, std::ios_base::dec | std::ios_base::left })
+  {
+    std::ostringstream out;
+    out.flags(flags);
+    out.width(12);
+    
+    std::ostringstream expected;
+    expected.flags(flags);
+    expected.width(12);
+    expected << std::write_all(v);
+    
+    auto p = std::write_all(std::parallel_formatting{1000, 4}, v);
+    
+    EXPECT_TRUE(out << p);
+    EXPECT_EQ(expected.str(), out.str());
+    EXPECT_EQ(v.size(), p.count);
+    EXPECT_TRUE(v.end() == p.next);
+  }
+  {
+    std::ostringstream out;
+    EXPECT_TRUE(out << std::write_all(std::parallel_formatting{1, 3}, s));
+    EXPECT_EQ(std::size_t{120000}, out.str().size());
+  }
+  {
+    std::ostringstream out;
+    EXPECT_TRUE(out << std::write_all(std::parallel_formatting{1000000, 4}, v));
+    
+    std::ostringstream expected;
+    expected << std::write_all(v);
+    EXPECT_EQ(expected.str(), out.str());
+  }
+  {
+    auto const b = std::vector<bool>(20000, true);
+    
+    std::ostringstream out;
+    EXPECT_TRUE(out << std::write_all(std::parallel_formatting{1, 4}, b));
+    EXPECT_EQ(std::string(20000, '1'), out.str());
+  }
+}
+
+/* Test: Error checking with parallel formatting.
+ * 
+ * If the stream buffer can't take all the output, or an element can't be
+ * written, the stream should go bad, and the count and next members should
+ * reflect the values that were completely written - just like when the range
+ * is written sequentially, and even if the stream throws on badbit.
+ */
+TEST(WriteAll, ParallelErrorChecking)
+{
+  {
+    auto const v = std::vector<int>(50000, 12);
+    
+    fixed_size_buffer<50001> sb;
+    std::ostream out{&sb};
+    
+    auto p = std::write_all(std::parallel_formatting{1, 4}, v);
+    
+    EXPECT_FALSE(out << p);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ(std::size_t{50001}, sb.str().size());
+    EXPECT_EQ(std::size_t{25000}, p.count);
+    EXPECT_TRUE(v.begin() + 25000 == p.next);
+  }
+  {
+    auto v = std::vector<char const*>(40000, "x");
+    v[30000] = nullptr;
+    
+    std::ostringstream out;
+    
+    auto p = std::write_all(std::parallel_formatting{1, 4}, v);
+    
+    EXPECT_FALSE(out << p);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ(std::string(30000, 'x'), out.str());
+    EXPECT_EQ(std::size_t{30000}, p.count);
+    EXPECT_TRUE(v.begin() + 30000 == p.next);
+  }
+  {
+    auto const v = std::vector<int>(50000, 12);
+    
+    fixed_size_buffer<50001> sb;
+    std::ostream out{&sb};
+    out.exceptions(std::ios_base::badbit);
+    
+    auto p = std::write_all(std::parallel_formatting{1, 4}, v);
+    
+    EXPECT_THROW(out << p, std::ios_base::failure);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ(std::size_t{25000}, p.count);
+    EXPECT_TRUE(v.begin() + 25000 == p.next);
+  }
+  {
+    auto v = std::vector<char const*>(40000, "x");
+    v[30000] = nullptr;
+    
+    std::ostringstream out;
+    out.exceptions(std::ios_base::badbit);
+    
+    auto p = std::write_all(std::parallel_formatting{1, 4}, v);
+    
+    EXPECT_THROW(out << p, std::ios_base::failure);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ(std::string(30000, 'x'), out.str());
+    EXPECT_EQ(std::size_t{30000}, p.count);
+    EXPECT_TRUE(v.begin() + 30000 == p.next);
+  }
+}
+
+/* Test: Shortest round-trip output of floating point ranges.
+ * 
+ * With shortest_round_trip, every floating point value must read back as
+ * exactly the same value, whatever the stream's precision, and the stream's
+ * precision must be left unchanged. Where the shortest form can be produced
+ * directly, that is what should be written.
+ */
+TEST(WriteAll, ShortestRoundTrip)
+{
+  auto const d = std::vector<double>{ 0.1, -2.5, 1.0 / 3.0, 6.02214076e23, -1.602176634e-19, 1e300, 5e-324, 100.0 };
+  auto const f = std::vector<float>{ 0.1f, -3.25f, 1e-10f, 3.4e38f };
+  
+  for (auto flags : { std::ios_base::fmtflags{}, std::ios_base::scientific, std::ios_base::showpoint, std::ios_base::fixed,
+    std::ios_base::fixed | std::ios_base::showpoint })
+  {
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out.flags(flags);
+    
+    EXPECT_TRUE(out << std::write_all(std::shortest_round_trip, d, ' '));
+    EXPECT_EQ(6, out.precision());
+    
+    std::istringstream in{out.str()};
+    for (auto v : d)
+    {
+      auto x = 0.0;
+      EXPECT_TRUE(in >> x);
+      EXPECT_EQ(v, x) << out.str();
+    }
+  }
+  {
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    
+    EXPECT_TRUE(out << std::write_all(std::shortest_round_trip, f, ' '));
+    
+    std::istringstream in{out.str()};
+    for (auto v : f)
+    {
+      auto x = 0.0f;
+      EXPECT_TRUE(in >> x);
+      EXPECT_EQ(v, x) << out.str();
+    }
+  }
+  {
+    auto const loc = std::locale{std::locale::classic(), new grouping_numpunct};
+    auto const small = std::vector<double>{ 1e-10, -1.602176634e-19, 0.1 / 3.0, 1234.5 };
+    
+    std::ostringstream out;
+    out.imbue(loc);
+    out.setf(std::ios_base::fixed);
+    
+    EXPECT_TRUE(out << std::write_all(std::shortest_round_trip, small, ' '));
+    
+    std::istringstream in{out.str()};
+    in.imbue(loc);
+    for (auto v : small)
+    {
+      auto x = 0.0;
+      EXPECT_TRUE(in >> x);
+      EXPECT_EQ(v, x) << out.str();
+    }
+  }
+#ifdef STD_RANGEIO_HAVE_TO_CHARS
+  {
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out.setf(std::ios_base::showpos | std::ios_base::uppercase);
+    out.width(8);
+    
+    EXPECT_TRUE(out << std::write_all(std::shortest_round_trip, {0.1, 1e300, 100.0}));
+    EXPECT_EQ("    +0.1 +1E+300    +100", out.str());
+  }
+  {
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    
+    EXPECT_TRUE(out << std::write_all(std::shortest_round_trip, f, ", "));
+    EXPECT_EQ("0.1, -3.25, 1e-10, 3.4e+38", out.str());
+  }
+#endif
+}
+
+/* Test: Output of arithmetic ranges with the stream's locale.
+ * 
+ * When the stream's locale isn't the classic one, arithmetic values should be
+ * written with the stream's num_put facet, exactly like their inserters would.
+ */
+TEST(WriteAll, Locale)
+{
+  auto const loc = std::locale{std::locale::classic(), new grouping_numpunct};
+  
+  auto const i = std::vector<int>{ 0, 1234, -1234567, std::numeric_limits<int>::min() };
+  auto const s = std::list<short>{ -1, 12345 };
+  auto const d = std::vector<double>{ 1234.5, -0.25, 1e10 };
+  auto const b = std::vector<bool>{ true, false, true };
+  
+  for_each_format<char>([&](std::ostream& fmt)
+  {
+    fmt.imbue(loc);
+    
+    { std::ostringstream out; out.copyfmt(fmt); out.width(fmt.width()); out << std::write_all(i); EXPECT_EQ(write_one_by_one(fmt, i), out.str()); }
+    { std::ostringstream out; out.copyfmt(fmt); out.width(fmt.width()); out << std::write_all(s); EXPECT_EQ(write_one_by_one(fmt, s), out.str()); }
+    { std::ostringstream out; out.copyfmt(fmt); out.width(fmt.width()); out << std::write_all(d); EXPECT_EQ(write_one_by_one(fmt, d), out.str()); }
+    { std::ostringstream out; out.copyfmt(fmt); out.width(fmt.width()); out << std::write_all(b); EXPECT_EQ(write_one_by_one(fmt, b), out.str()); }
+    
+    fmt.setf(std::ios_base::boolalpha);
+    { std::ostringstream out; out.copyfmt(fmt); out.width(fmt.width()); out << std::write_all(b); EXPECT_EQ(write_one_by_one(fmt, b), out.str()); }
+  });
+  
+  {
+    std::ostringstream out;
+    out.imbue(loc);
+    out.width(8);
+    
+    EXPECT_TRUE(out << std::write_all(i, ';'));
+    EXPECT_EQ("       0;   1.234;-1.234.567;-2.147.483.648", out.str());
+  }
+}
+
+/* Test: Direct output of ranges of characters and strings.
+ * 
+ * Characters and strings are written directly to the stream buffer, but the
+ * output must be exactly the same as if each element were written with its
+ * own inserter.
+ */
+TEST(WriteAll, DirectStrings)
+{
+  auto const c = std::list<char>{ 'a', 'b', 'c' };
+  auto const s = std::vector<std::string>{ "one", "", "three", "fourteen" };
+  auto const p = std::list<char const*>{ "x", "yy", "zzz" };
+  auto const w = std::vector<std::wstring>{ L"one", L"", L"three" };
+  
+  for (auto adjust : { std::ios_base::left, std::ios_base::right, std::ios_base::internal })
+  {
+    for (auto width : { 0, 1, 4 })
+    {
+      std::ostringstream fmt;
+      fmt.setf(adjust, std::ios_base::adjustfield);
+      fmt.width(width);
+      fmt.fill('.');
+      
+      { std::ostringstream out; out.copyfmt(fmt); out.width(width); EXPECT_TRUE(out << std::write_all(c)); EXPECT_EQ(write_one_by_one(fmt, c), out.str()); }
+      { std::ostringstream out; out.copyfmt(fmt); out.width(width); EXPECT_TRUE(out << std::write_all(s)); EXPECT_EQ(write_one_by_one(fmt, s), out.str()); }
+      { std::ostringstream out; out.copyfmt(fmt); out.width(width); EXPECT_TRUE(out << std::write_all(p)); EXPECT_EQ(write_one_by_one(fmt, p), out.str()); }
+      
+      std::wostringstream wfmt;
+      wfmt.setf(adjust, std::ios_base::adjustfield);
+      wfmt.width(width);
+      wfmt.fill(L'.');
+      
+      { std::wostringstream out; out.copyfmt(wfmt); out.width(width); EXPECT_TRUE(out << std::write_all(w)); EXPECT_TRUE(write_one_by_one(wfmt, w) == out.str()); }
+    }
+  }
+  {
+    auto const r = std::vector<char const*>{ "a", nullptr, "c" };
+    
+    std::ostringstream out;
+    
+    auto p = std::write_all(r);
+    
+    EXPECT_FALSE(out << p);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ("a", out.str());
+    EXPECT_EQ(std::size_t{1}, p.count);
+    EXPECT_TRUE(r.begin() + 1 == p.next);
+  }
+}
+
+/* Test: Tied streams when using write_all().
+ * 
+ * When the elements are written directly, a tied stream should be flushed
+ * only once for the whole range, not once per element.
+ */
+TEST(WriteAll, SingleSentry)
+{
+  flush_counting_buffer tied_buffer;
+  std::ostream tied{&tied_buffer};
+  
+  std::ostringstream out;
+  out.imbue(std::locale::classic());
+  out.tie(&tied);
+  
+  EXPECT_TRUE(out << std::write_all(std::forward_list<int>{ 1, 2, 3, 4 }));
+  EXPECT_EQ("1234", out.str());
+  EXPECT_EQ(1, tied_buffer.flushes);
+}
+
+/* Test: Formatting with element types that change the formatting state.
+ * 
+ * If an element's inserter changes the formatting state of the stream, the
+ * state must still be restored for every following element.
+ */
+TEST(WriteAll, FormattingChangedByElements)
+{
+  auto const r = std::array<format_changer, 3>{{ {10}, {20}, {30} }};
+  
+  std::ostringstream oss;
+  oss.imbue(std::locale::classic());
+  oss.width(3);
+  oss.fill('_');
+  
+  EXPECT_TRUE(oss << std::write_all(r));
+  EXPECT_EQ("_10_20_30", oss.str());
+}
+
+/* Test: Output of contiguous character ranges.
+ * 
+ * Contiguous ranges of the stream's character type are written all at once,
+ * but padding must still be applied to each character.
+ */
+TEST(WriteAll, ContiguousCharacters)
+{
+  auto const v = std::vector<char>{ 'a', 'b', 'c' };
+  auto const s = std::string{"hello"};
+  char const a[] = { 'x', 'y' };
+  
+  {
+    std::ostringstream out;
+    
+    EXPECT_TRUE(out << std::write_all(v) << std::write_all(s) << std::write_all(a));
+    EXPECT_EQ("abchelloxy", out.str());
+  }
+  {
+    std::ostringstream out;
+    out.width(1);
+    
+    EXPECT_TRUE(out << std::write_all(s));
+    EXPECT_EQ(0, out.width());
+    EXPECT_EQ("hello", out.str());
+  }
+  {
+    std::ostringstream out;
+    out.width(2);
+    out.fill('_');
+    
+    EXPECT_TRUE(out << std::write_all(v));
+    EXPECT_EQ("_a_b_c", out.str());
+  }
+  {
+    std::wostringstream out;
+    
+    EXPECT_TRUE(out << std::write_all(std::wstring{L"wide"}));
+    EXPECT_TRUE(L"wide" == out.str());
+  }
+  {
+    fixed_size_buffer<3> sb;
+    std::ostream out{&sb};
+    
+    auto p = std::write_all(s);
+    
+    EXPECT_FALSE(out << p);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ("hel", sb.str());
+    EXPECT_EQ(std::size_t{3}, p.count);
+    EXPECT_TRUE(s.begin() + 3 == p.next);
+  }
+}
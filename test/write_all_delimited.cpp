@@ -24,12 +24,15 @@
 #include <array>
 #include <forward_list>
 #include <initializer_list>
+#include <ios>
 #include <iterator>
+#include <list>
 #include <sstream>
 #include <string>
 #include <type_traits>
+#include <vector>
 
-#include <rangeio>
+#include <rangeio_parallel>
 
 #include "gtest/gtest.h"
 
@@ -106,6 +109,39 @@ auto operator<<(std::basic_ostream<CharT, Traits>& out, incrementing_integer_del
   return out;
 }
 
+/* 
+ * A type with its own inserter, so it is never written directly.
+ */
+struct wrapped_int
+{
+  int value;
+};
+
+auto operator<<(std::ostream& out, wrapped_int const& w) -> std::ostream&
+{
+  return out << w.value;
+}
+
+/* 
+ * A stream buffer that can hold only a fixed number of characters. Once it is
+ * full, all further output fails.
+ */
+template <std::size_t N>
+struct fixed_size_buffer : std::streambuf
+{
+  fixed_size_buffer()
+  {
+    setp(buffer, buffer + N);
+  }
+  
+  auto str() const -> std::string
+  {
+    return {pbase(), pptr()};
+  }
+  
+  char buffer[N];
+};
+
 } // anonymous namespace
 
 /* Test: Verify the types associated with the delimited write_all() are
@@ -301,4 +337,247 @@ TEST(WriteAllDelim, Formatting)
     EXPECT_TRUE(oss << std::write_all(r, " | "));
     EXPECT_EQ("____1.00 | -___2.30 | ____6.67 | -__0.123 | -___1.23", oss.str());
   }
+  {
+    auto const v = std::vector<int>{ 10, 11, 12 };
+    
+    std::ostringstream oss;
+    
+    // The manipulator changes the formatting between elements, but the
+    // formatting should be restored before each element anyway.
+    EXPECT_TRUE(oss << std::write_all(v, std::hex));
+    EXPECT_EQ("101112", oss.str());
+  }
+}
+
+/* Test: Pre-rendered delimiters.
+ * 
+ * Character and string delimiters are rendered once and written directly,
+ * but the output must be exactly the same as writing them with their
+ * inserters - including widening for wide streams.
+ */
+TEST(WriteAllDelim, RenderedDelimiters)
+{
+  auto const v = std::vector<int>{ 1, -2, 3 };
+  auto const l = std::list<std::string>{ "a", "bb", "ccc" };
+  auto const w = std::vector<wrapped_int>{ {1}, {2}, {3} };
+  
+  {
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out.width(3);
+    
+    EXPECT_TRUE(out << std::write_all(v, ", "));
+    EXPECT_EQ("  1,  -2,   3", out.str());
+  }
+  {
+    std::ostringstream out;
+    out.setf(std::ios_base::left, std::ios_base::adjustfield);
+    out.width(4);
+    out.fill('.');
+    
+    EXPECT_TRUE(out << std::write_all(l, std::string{"|"}));
+    EXPECT_EQ("a...|bb..|ccc.", out.str());
+  }
+  {
+    std::ostringstream out;
+    
+    auto const c = static_cast<unsigned char>('+');
+    EXPECT_TRUE(out << std::write_all(w, c));
+    EXPECT_EQ("1+2+3", out.str());
+  }
+  {
+    std::ostringstream out;
+    
+    EXPECT_TRUE(out << std::write_all(w, ""));
+    EXPECT_EQ("123", out.str());
+  }
+  {
+    std::wostringstream out;
+    out.imbue(std::locale::classic());
+    
+    EXPECT_TRUE(out << std::write_all(v, " - "));
+    EXPECT_TRUE(L"1 - -2 - 3" == out.str());
+  }
+  {
+    std::wostringstream out;
+    out.imbue(std::locale::classic());
+    
+    EXPECT_TRUE(out << std::write_all(v, ';'));
+    EXPECT_TRUE(L"1;-2;3" == out.str());
+  }
+  {
+    std::wostringstream out;
+    out.imbue(std::locale::classic());
+    
+    EXPECT_TRUE(out << std::write_all(v, std::wstring{L"::"}));
+    EXPECT_TRUE(L"1::-2::3" == out.str());
+  }
+}
+
+/* Test: Block formatting of contiguous integer ranges with delimiters.
+ * 
+ * The delimiters are formatted into the same blocks as the integers, unless
+ * they are too long for them. Either way, the output must be exactly the
+ * same as writing the elements and delimiters with their inserters.
+ */
+TEST(WriteAllDelim, IntegerBlocks)
+{
+  auto v = std::vector<long>{};
+  for (auto n = 0L; n < 100; ++n)
+    v.push_back((n % 3) ? n * 1234567L : -n * 98765432123L);
+  
+  for (auto d : { std::string{","}, std::string{" | "}, std::string(100, '-') })
+  {
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out.width(20);
+    
+    std::ostringstream expected;
+    for (auto i = v.begin(); i != v.end(); ++i)
+    {
+      if (i != v.begin())
+        expected << d;
+      expected.width(20);
+      expected << *i;
+    }
+    
+    EXPECT_TRUE(out << std::write_all(v, d));
+    EXPECT_EQ(expected.str(), out.str());
+  }
+}
+
+/* Test: Parallel formatting with delimiters.
+ * 
+ * The delimiters must go between the elements, including the elements at the
+ * ends of the chunks formatted on different threads, and the count and next
+ * members should be exactly the same as when the range is written
+ * sequentially.
+ */
+TEST(WriteAllDelim, Parallel)
+{
+  auto v = std::vector<long>(100000);
+  for (auto n = 0u; n < v.size(); ++n)
+    v[n] = static_cast<long>(n) * ((n % 3) ? 104729L : -7919L);
+  
+  for (auto d : { std::string{","}, std::string(100, '-') })
+  {
+    std::ostringstream out;
+    out.width(9);
+    
+    std::ostringstream expected;
+    expected.width(9);
+    expected << std::write_all(v, d);
+    
+    auto p = std::write_all(std::parallel_formatting{1000, 4}, v, d);
+    
+    EXPECT_TRUE(out << p);
+    EXPECT_EQ(expected.str(), out.str());
+    EXPECT_EQ(v.size(), p.count);
+    EXPECT_TRUE(v.end() == p.next);
+  }
+  {
+    auto const w = std::vector<int>(30000, 7);
+    
+    fixed_size_buffer<40001> sb;
+    std::ostream out{&sb};
+    
+    auto p = std::write_all(std::parallel_formatting{1, 4}, w, ", ");
+    
+    EXPECT_FALSE(out << p);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ(std::size_t{13334}, p.count);
+    EXPECT_TRUE(w.begin() + 13334 == p.next);
+  }
+}
+
+/* Test: Error checking with pre-rendered delimiters.
+ * 
+ * A null delimiter is an error, just like writing it with its inserter. If
+ * the stream buffer can't take all the output, the stream should go bad, and
+ * the count and next members should reflect the values that were completely
+ * written.
+ */
+TEST(WriteAllDelim, RenderedDelimitersErrorChecking)
+{
+  {
+    auto const v = std::vector<int>{ 1, 2, 3 };
+    
+    std::ostringstream out;
+    
+    auto const d = static_cast<char const*>(nullptr);
+    auto p = std::write_all(v, d);
+    
+    EXPECT_FALSE(out << p);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ("1", out.str());
+    EXPECT_EQ(std::size_t{1}, p.count);
+  }
+  {
+    auto const v = std::vector<int>{ 123, 456, 789 };
+    
+    fixed_size_buffer<9> sb;
+    std::ostream out{&sb};
+    
+    auto p = std::write_all(v, ", ");
+    
+    EXPECT_FALSE(out << p);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ("123, 456,", sb.str());
+    EXPECT_EQ(std::size_t{2}, p.count);
+    EXPECT_TRUE(v.begin() + 2 == p.next);
+  }
+  {
+    auto const v = std::vector<int>(100, 12);
+    
+    fixed_size_buffer<80> sb;
+    std::ostream out{&sb};
+    
+    auto p = std::write_all(v, ",");
+    
+    EXPECT_FALSE(out << p);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ(std::size_t{80}, sb.str().size());
+    EXPECT_EQ(std::size_t{27}, p.count);
+    EXPECT_TRUE(v.begin() + 27 == p.next);
+  }
+}
+
+/* Test: Error checking when the stream throws on badbit.
+ * 
+ * When output fails part way through and the exception is rethrown, count and
+ * next should still say how much of the range was written, including output
+ * that was staged before the failure.
+ */
+TEST(WriteAllDelim, ExceptionsErrorChecking)
+{
+  {
+    auto const v = std::vector<int>{ 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    
+    fixed_size_buffer<10> sb;
+    std::ostream out{&sb};
+    out.exceptions(std::ios_base::badbit);
+    
+    auto p = std::write_all(v, " ");
+    
+    EXPECT_THROW(out << p, std::ios_base::failure);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ("1 2 3 4 5 ", sb.str());
+    EXPECT_EQ(std::size_t{5}, p.count);
+    EXPECT_TRUE(v.begin() + 5 == p.next);
+  }
+  {
+    auto const l = std::list<int>{ 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    
+    fixed_size_buffer<10> sb;
+    std::ostream out{&sb};
+    out.exceptions(std::ios_base::badbit);
+    
+    auto p = std::write_all(l, " ");
+    
+    EXPECT_THROW(out << p, std::ios_base::failure);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ("1 2 3 4 5 ", sb.str());
+    EXPECT_EQ(std::size_t{5}, p.count);
+    EXPECT_TRUE(std::next(l.begin(), 5) == p.next);
+  }
 }
@@ -0,0 +1,160 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/* 
+ * This file contains the tests for the proposed range streaming facilities -
+ * specifically the binary output version.
+ * 
+ * These tests are not meant to be exhaustive, merely illustrative.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <rangeio>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+/* 
+ * A stream buffer with room for a fixed number of characters, like a disk
+ * that fills up.
+ */
+struct full_buffer : std::streambuf
+{
+  explicit full_buffer(std::size_t n) :
+    s_(n, '\0')
+  {
+    setp(&s_[0], &s_[0] + n);
+  }
+  
+  std::string s_;
+};
+
+/* 
+ * Writes the object representations of the values in v to a string.
+ */
+template <typename T>
+auto binary_string(std::vector<T> const& v) -> std::string
+{
+  return std::string(reinterpret_cast<char const*>(v.data()), v.size() * sizeof(T));
+}
+
+} // anonymous namespace
+
+/* Test: Output with write_binary().
+ * 
+ * write_binary() should write the object representations of the values, for
+ * contiguous ranges and for ranges that have to be copied a block at a time,
+ * so that they can be read back with read_binary().
+ */
+TEST(WriteBinary, Output)
+{
+  auto values = std::vector<double>{};
+  for (auto n = 0; n < 10000; ++n)
+    values.push_back(n * 0.125 + 3.0);
+  
+  {
+    std::ostringstream oss;
+    oss.width(100);
+    
+    auto p = std::write_binary(values);
+    
+    EXPECT_TRUE(oss << p);
+    EXPECT_EQ(std::size_t{10000}, p.count);
+    EXPECT_TRUE(values.end() == p.next);
+    EXPECT_EQ(binary_string(values), oss.str());
+    
+    auto r = std::vector<double>{};
+    std::istringstream iss{oss.str()};
+    
+    EXPECT_TRUE(iss >> std::read_binary_n(r, values.size()));
+    EXPECT_EQ(values, r);
+  }
+  
+  {
+    auto const l = std::list<double>(values.begin(), values.end());
+    
+    std::ostringstream oss;
+    
+    auto p = std::write_binary(l);
+    
+    EXPECT_TRUE(oss << p);
+    EXPECT_EQ(std::size_t{10000}, p.count);
+    EXPECT_TRUE(l.end() == p.next);
+    EXPECT_EQ(binary_string(values), oss.str());
+  }
+  
+  {
+    std::ostringstream oss;
+    
+    EXPECT_TRUE(oss << std::write_binary({ std::int16_t{1}, std::int16_t{-2} }));
+    EXPECT_EQ(binary_string(std::vector<std::int16_t>{ 1, -2 }), oss.str());
+  }
+}
+
+/* Test: Error checking with write_binary().
+ * 
+ * If the stream buffer fills up, badbit should be set, and count and next
+ * should only take in the values that were written in full.
+ */
+TEST(WriteBinary, ErrorChecking)
+{
+  auto const v = std::vector<std::int32_t>{ 1, 2, 3, 4, 5 };
+  auto const l = std::list<std::int32_t>(v.begin(), v.end());
+  
+  {
+    full_buffer buf{10};
+    std::ostream out{&buf};
+    
+    auto p = std::write_binary(v);
+    
+    EXPECT_FALSE(out << p);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ(std::size_t{2}, p.count);
+    EXPECT_TRUE(std::next(v.begin(), 2) == p.next);
+  }
+  
+  {
+    full_buffer buf{13};
+    std::ostream out{&buf};
+    
+    auto p = std::write_binary(l);
+    
+    EXPECT_FALSE(out << p);
+    EXPECT_TRUE(out.bad());
+    EXPECT_EQ(std::size_t{3}, p.count);
+    EXPECT_TRUE(std::next(l.begin(), 3) == p.next);
+  }
+  
+  {
+    std::ostringstream oss;
+    oss.setstate(std::ios_base::failbit);
+    
+    auto p = std::write_binary(v);
+    
+    EXPECT_FALSE(oss << p);
+    EXPECT_EQ(std::size_t{0}, p.count);
+    EXPECT_TRUE(oss.str().empty());
+  }
+}
@@ -0,0 +1,271 @@
+/* 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* 
+ * This file contains the tests for the proposed range streaming facilities -
+ * specifically writing the output of write_all() to strings, vectors and
+ * output iterators, without a stream.
+ * 
+ * These tests are not meant to be exhaustive, merely illustrative.
+ */
+
+#include <array>
+#include <ios>
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <rangeio>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+/* 
+ * A type with its own inserter, which can't be written directly.
+ */
+struct point
+{
+  int x;
+  int y;
+};
+
+auto operator<<(std::ostream& out, point const& p) -> std::ostream&
+{
+  return out << '(' << p.x << ',' << p.y << ')';
+}
+
+/* 
+ * A delimiter whose value increments every time it is written, so it gives
+ * different output if it is written more than once per element.
+ */
+struct incrementing_delimiter
+{
+  unsigned i = 0u;
+};
+
+auto operator<<(std::ostream& out, incrementing_delimiter& d) -> std::ostream&
+{
+  return out << '<' << d.i++ << '>';
+}
+
+/* 
+ * A type whose inserter throws for values marked bad, after writing a
+ * character.
+ */
+struct fragile
+{
+  bool bad;
+};
+
+auto operator<<(std::ostream& out, fragile const& f) -> std::ostream&
+{
+  out << (f.bad ? '!' : '.');
+  
+  if (f.bad)
+    throw std::runtime_error{"bad value"};
+  
+  return out;
+}
+
+/* 
+ * Writes a range writer to a newly constructed string stream. This is what
+ * write_to() should be equivalent to.
+ */
+template <typename Writer>
+auto stream_output(Writer&& w) -> std::string
+{
+  std::ostringstream out;
+  out << w;
+  return out.str();
+}
+
+} // anonymous namespace
+
+/* Test: Verify the types associated with write_to() are correct.
+ * 
+ * write_to() should return a reference to the string or vector it appended
+ * to, or the output iterator past the last character written.
+ */
+TEST(WriteTo, Types)
+{
+  auto const r = std::vector<int>{};
+  auto s = std::string{};
+  auto v = std::vector<char>{};
+  auto l = std::list<char>{};
+  
+  EXPECT_TRUE((std::is_same<std::string&, decltype(std::write_to(s, std::write_all(r)))>::value));
+  EXPECT_TRUE((std::is_same<std::vector<char>&, decltype(std::write_to(v, std::write_all(r, ',')))>::value));
+  EXPECT_TRUE((std::is_same<std::back_insert_iterator<std::list<char>>, decltype(std::write_to(std::back_inserter(l), std::write_all(r)))>::value));
+}
+
+/* Test: Output to strings, vectors and output iterators.
+ * 
+ * The output should be appended to strings and vectors, and should be exactly
+ * what writing to a newly constructed string stream would produce.
+ */
+TEST(WriteTo, Output)
+{
+  auto const i = std::vector<int>{ 1, -22, 333 };
+  auto const p = std::list<point>{ {1, 2}, {3, 4} };
+  auto const d = std::array<double, 3>{{ 0.5, 1e100, -3.25 }};
+  
+  {
+    auto s = std::string{"ints: "};
+    
+    EXPECT_EQ("ints: 1, -22, 333", std::write_to(s, std::write_all(i, ", ")));
+    EXPECT_EQ("ints: 1, -22, 333(1,2)(3,4)", std::write_to(s, std::write_all(p)));
+  }
+  {
+    auto s = std::string{};
+    std::write_to(s, std::write_all(d, ' '));
+    EXPECT_EQ(stream_output(std::write_all(d, ' ')), s);
+  }
+  {
+    auto v = std::vector<char>{ '>' };
+    std::write_to(v, std::write_all(p, " - "));
+    EXPECT_EQ(">" + stream_output(std::write_all(p, " - ")), std::string(v.begin(), v.end()));
+  }
+  {
+    char buffer[32] = {};
+    auto const last = std::write_to(buffer, std::write_all(i, '|'));
+    EXPECT_EQ("1|-22|333", std::string(buffer, last));
+  }
+  {
+    auto l = std::list<char>{};
+    std::write_to(std::back_inserter(l), std::write_all({ 4, 5, 6 }));
+    EXPECT_EQ("456", std::string(l.begin(), l.end()));
+  }
+  {
+    auto w = std::wstring{};
+    std::write_to(w, std::write_all(i, L", "));
+    EXPECT_TRUE(L"1, -22, 333" == w);
+  }
+  {
+    auto big = std::vector<long>(10000);
+    for (auto n = 0u; n < big.size(); ++n)
+      big[n] = static_cast<long>(n) * 104729L;
+    
+    auto s = std::string{};
+    std::write_to(s, std::write_all(big, '\n'));
+    EXPECT_EQ(stream_output(std::write_all(big, '\n')), s);
+  }
+}
+
+/* Test: Error checking on write_to().
+ * 
+ * The count and next members of the range writer should be updated just like
+ * when writing to a stream. Errors are reported with exceptions, and the
+ * output written before the error should still reach the target.
+ */
+TEST(WriteTo, ErrorChecking)
+{
+  {
+    auto const r = std::vector<int>{ 7, 8, 9 };
+    auto w = std::write_all(r);
+    auto s = std::string{};
+    
+    std::write_to(s, w);
+    EXPECT_EQ("789", s);
+    EXPECT_EQ(std::size_t{3}, w.count);
+    EXPECT_TRUE(r.end() == w.next);
+  }
+  {
+    auto const r = std::vector<char const*>{ "a", nullptr, "c" };
+    auto s = std::string{};
+    
+    EXPECT_THROW(std::write_to(s, std::write_all(r)), std::ios_base::failure);
+    EXPECT_EQ("a", s);
+  }
+  {
+    auto const r = std::vector<fragile>{ {false}, {false}, {true}, {false} };
+    auto s = std::string{"> "};
+    auto w = std::write_all(r, ",");
+    
+    EXPECT_THROW(std::write_to(s, w), std::runtime_error);
+    EXPECT_EQ("> .,.,!", s);
+    EXPECT_EQ(std::size_t{2}, w.count);
+  }
+  {
+    auto const r = std::vector<char const*>{ "a", "b", nullptr };
+    auto v = std::vector<char>{};
+    
+    EXPECT_THROW(std::write_to(std::exact_size, v, std::write_all(r, ' ')), std::ios_base::failure);
+    EXPECT_EQ("a b ", std::string(v.begin(), v.end()));
+  }
+}
+
+/* Test: Output with exact_size.
+ * 
+ * The output should be the same as without exact_size, but the space for it
+ * should be reserved up front, in one go, when it can be measured without
+ * calling any inserters.
+ */
+TEST(WriteTo, ExactSize)
+{
+  auto const i = std::vector<long long>{ 0, -1, 9, 10, -99, 100, 12345678, -123456789, 9223372036854775807LL, -9223372036854775807LL - 1 };
+  auto const u = std::list<unsigned short>{ 0, 1, 65535 };
+  auto const p = std::list<point>{ {1, 2}, {-3, 44} };
+  auto const s = std::vector<std::string>{ "abc", "", "de" };
+  
+  {
+    auto v = std::vector<char>{};
+    std::write_to(std::exact_size, v, std::write_all(i, ", "));
+    EXPECT_EQ(stream_output(std::write_all(i, ", ")), std::string(v.begin(), v.end()));
+    EXPECT_EQ(v.size(), v.capacity());
+  }
+  {
+    auto v = std::vector<char>{};
+    std::write_to(std::exact_size, v, std::write_all(u));
+    EXPECT_EQ("0165535", std::string(v.begin(), v.end()));
+    EXPECT_EQ(v.size(), v.capacity());
+  }
+  {
+    auto v = std::vector<char>{};
+    std::write_to(std::exact_size, v, std::write_all(p, ' '));
+    EXPECT_EQ("(1,2) (-3,44)", std::string(v.begin(), v.end()));
+  }
+  {
+    auto v = std::vector<char>{};
+    std::write_to(std::exact_size, v, std::write_all(u, incrementing_delimiter{}));
+    EXPECT_EQ(stream_output(std::write_all(u, incrementing_delimiter{})), std::string(v.begin(), v.end()));
+    EXPECT_EQ("0<0>1<1>65535", std::string(v.begin(), v.end()));
+  }
+  {
+    auto v = std::vector<char>{};
+    std::write_to(std::exact_size, v, std::write_all(s, "--"));
+    EXPECT_EQ("abc----de", std::string(v.begin(), v.end()));
+    EXPECT_EQ(v.size(), v.capacity());
+  }
+  {
+    auto big = std::vector<int>(5000);
+    for (auto n = 0u; n < big.size(); ++n)
+      big[n] = static_cast<int>(n) * ((n % 2) ? -7919 : 7919);
+    
+    auto str = std::string{"big: "};
+    std::write_to(std::exact_size, str, std::write_all(big, '\n'));
+    EXPECT_EQ("big: " + stream_output(std::write_all(big, '\n')), str);
+    EXPECT_EQ(str.size(), str.capacity());
+  }
+  {
+    auto w = std::wstring{};
+    std::write_to(std::exact_size, w, std::write_all(i, L' '));
+    EXPECT_EQ(stream_output(std::write_all(i, ' ')).size(), w.size());
+  }
+}